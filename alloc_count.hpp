@@ -0,0 +1,37 @@
+#ifndef LXJSON_ALLOC_COUNT_HPP
+#define LXJSON_ALLOC_COUNT_HPP
+
+//Replaces the global operator new and delete to count every allocation, so that the tests can
+//check the parser does not copy subtrees and the benchmarks can report allocations per operation.
+//The replacements are not inline: include this from the file holding main() and nowhere else.
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> alloc_count(0);
+
+//GCC 11+ sees malloc behind operator new and free behind operator delete once they are inlined
+//into a new/delete pair, and takes them for a mismatch
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 11)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size){
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept{
+    std::free(p);
+}
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 11)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
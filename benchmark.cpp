@@ -0,0 +1,871 @@
+#include "json.hpp"
+#include "alloc_count.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <thread>
+#include <atomic>
+
+using namespace lxjson;
+
+//run fn `iters` times and report the average cost of one call
+template<typename F>
+static double bench(const std::string &name, size_t iters, F fn){
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iters; ++i)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - begin).count() / iters;
+    std::cout << name << ": " << ns << " ns/op" << std::endl;
+    return ns;
+}
+
+static Json make_tree(size_t n){
+    Json::array arr;
+    for (size_t i = 0; i < n; ++i)
+        arr.push_back(Json(Json::object { { "id", Json(static_cast<int>(i)) }, { "name", Json("item") } }));
+    return Json(std::move(arr));
+}
+
+void bench_copy(){
+    //copying a Json must not depend on the size of the tree
+    for (size_t n : {10, 1000, 100000}){
+        Json tree = make_tree(n);
+        size_t sink = 0;
+        bench("copy tree of " + std::to_string(n) + " objects", 1000000, [&]{
+            Json copy = tree;
+            sink += copy.is_array();
+        });
+        if (!sink) std::abort();
+    }
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point begin){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+//a document made of many small records, the worst case for per-node allocations
+static std::string make_records(size_t n){
+    std::string out = "[";
+    for (size_t i = 0; i < n; ++i){
+        if (i) out += ",";
+        out += "{\"id\":" + std::to_string(i) + ",\"name\":\"record\",\"score\":" + std::to_string(i * 0.25)
+            + ",\"tags\":[\"a\",\"b\",\"c\"],\"active\":true,\"parent\":null}";
+    }
+    out += "]";
+    return out;
+}
+
+//parse + teardown in a child process, so that the peak RSS of each mode is measured on its own
+template<typename F>
+static void run_isolated(const std::string &name, F fn){
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0){
+        fn();
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        std::cout << name << ": peak RSS " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+        std::exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+}
+
+void bench_arena(){
+    std::string in = make_records(50000);
+    std::cout << "document: " << in.size() / 1024 << " KB" << std::endl;
+
+    run_isolated("heap mode", [&]{
+        std::string err;
+        auto begin = std::chrono::steady_clock::now();
+        Json *doc = new Json(Json::parse(in, err));
+        std::cout << "heap mode: parse " << elapsed_ms(begin) << " ms" << std::endl;
+        begin = std::chrono::steady_clock::now();
+        delete doc;
+        std::cout << "heap mode: teardown " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    run_isolated("arena mode", [&]{
+        std::string err;
+        auto begin = std::chrono::steady_clock::now();
+        Json *doc = new Json(Json::parse(in, err, std::make_shared<Arena>(1 << 20)));
+        std::cout << "arena mode: parse " << elapsed_ms(begin) << " ms" << std::endl;
+        begin = std::chrono::steady_clock::now();
+        delete doc;
+        std::cout << "arena mode: teardown " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+}
+
+void bench_access(){
+    //type checks and numeric reads are plain loads on the inline representation
+    Json::array values;
+    for (int i = 0; i < 1000000; ++i)
+        values.push_back(i % 2 ? Json(i * 0.5) : Json(i));
+    Json arr(std::move(values));
+    double sum = 0;
+    bench("sum 1M numbers", 20, [&]{
+        for (auto &v : arr.array_value())
+            if (v.is_number()) sum += v.double_value();
+    });
+    std::string in = arr.serialize(), err;
+    bench("parse 1M numbers", 3, [&]{
+        Json ret = Json::parse(in, err);
+        sum += ret[0].double_value();
+    });
+    if (sum < 0) std::abort();
+}
+
+//log-ingest like records: mostly long ASCII strings, set LXJSON_NO_SIMD=1 to compare with the scalar scanners
+void bench_strings(){
+    std::string line = "GET /api/v1/items?id=12345&filter=active HTTP/1.1 200 - Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36";
+    std::string in = "[";
+    for (int i = 0; i < 20000; ++i){
+        if (i) in += ",\n    ";
+        in += "{\"message\": \"" + line + "\", \"host\": \"frontend-" + std::to_string(i % 16) + ".example.com\", "
+              "\"path\": \"/var/log/nginx/access.log\", \"note\": \"quoted \\\"value\\\" inside\"}";
+    }
+    in += "]";
+    std::string err;
+    double ns = bench("parse string-heavy document", 20, [&]{
+        Json ret = Json::parse(in, err);
+        if (!err.empty()) std::abort();
+    });
+    std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+}
+
+void bench_engines(){
+    std::string in = make_records(20000), err;
+    std::cout << "document: " << in.size() / 1024 << " KB" << std::endl;
+    bench("recursive descent", 10, [&]{
+        Json ret = Json::parse(in, err);
+    });
+    bench("two-stage, tape + tree", 10, [&]{
+        Json ret = Json::parse(in, err, Json::ParseEngine::TWO_STAGE);
+    });
+    JsonTape tape;
+    double ns = bench("two-stage, tape only (buffers reused)", 10, [&]{
+        if (!tape.parse(in, err)) std::abort();
+    });
+    std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+}
+
+//a GeoJSON-like polygon: one big array of [lon, lat] pairs
+void bench_numbers(){
+    std::string in = "{\"type\": \"Polygon\", \"coordinates\": [[";
+    srand(7);
+    for (int i = 0; i < 200000; ++i){
+        if (i) in += ",";
+        char pair[64];
+        snprintf(pair, sizeof(pair), "[%.7f,%.7f]", rand() / (double)RAND_MAX * 360 - 180, rand() / (double)RAND_MAX * 180 - 90);
+        in += pair;
+    }
+    in += "]], \"ids\": [";
+    for (int i = 0; i < 100000; ++i)
+        in += (i ? "," : "") + std::to_string(9007199254740993LL + i);
+    in += "]}";
+    std::string err;
+    double ns = bench("parse number-heavy document", 10, [&]{
+        Json ret = Json::parse(in, err);
+        if (!err.empty()) std::abort();
+    });
+    std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+
+    //what the numbers alone used to cost: strtod over every token
+    double sum = 0;
+    bench("strtod over the same numbers", 10, [&]{
+        const char *p = in.c_str();
+        while (*p){
+            if ((*p >= '0' && *p <= '9') || *p == '-'){
+                char *end;
+                sum += strtod(p, &end);
+                p = end;
+            }
+            else ++p;
+        }
+    });
+    if (sum == 0) std::abort();
+}
+
+//serialize arrays of doubles and of integers, next to what snprintf costs for the same numbers
+void bench_serialize(){
+    Json::array doubles, ints;
+    srand(11);
+    for (int i = 0; i < 1000000; ++i){
+        doubles.push_back(Json(rand() / (double)RAND_MAX * 360 - 180));
+        ints.push_back(Json(static_cast<int64_t>(rand()) * rand() - RAND_MAX));
+    }
+    Json d(std::move(doubles)), n(std::move(ints));
+    size_t sink = 0;
+    bench("serialize 1M doubles", 5, [&]{
+        std::string out;
+        d.serialize(out);
+        sink += out.size();
+    });
+    bench("serialize 1M integers", 5, [&]{
+        std::string out;
+        n.serialize(out);
+        sink += out.size();
+    });
+    bench("snprintf %.17g over the same doubles", 5, [&]{
+        char c[32];
+        for (auto &v : d.array_value())
+            sink += snprintf(c, sizeof(c), "%.17g", v.double_value());
+    });
+    bench("snprintf %lld over the same integers", 5, [&]{
+        char c[32];
+        for (auto &v : n.array_value())
+            sink += snprintf(c, sizeof(c), "%lld", static_cast<long long>(v.int64_value()));
+    });
+
+    //a whole document to a descriptor: through one big string, or streamed in blocks
+    std::string err;
+    Json records = Json::parse(make_records(200000), err);
+    int fd = open("/dev/null", O_WRONLY);
+    bench("records: serialize() + write()", 5, [&]{
+        std::string out = records.serialize();
+        sink += static_cast<size_t>(write(fd, out.data(), out.size()));
+    });
+    bench("records: serialize(FdSink)", 5, [&]{
+        FdSink to_fd(fd);
+        sink += records.serialize(to_fd);
+    });
+    close(fd);
+    if (!sink) std::abort();
+}
+
+//counts the values, the kind of scan that does not need the tree
+struct CountingHandler : JsonHandler {
+    size_t values = 0;
+    bool on_null() override {++values; return true;}
+    bool on_bool(bool) override {++values; return true;}
+    bool on_number(const Json &) override {++values; return true;}
+    bool on_string(const std::string &) override {++values; return true;}
+};
+
+//a file bigger than the chunks it is read by: streamed in 64 KB pieces, or read whole and parsed
+void bench_stream(){
+    char path[] = "/tmp/lxjson_stream_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) std::abort();
+    {
+        //the records of 8 documents in a single array
+        std::string records = make_records(50000);
+        records.front() = '[';
+        records.back() = ',';
+        for (int i = 0; i < 8; ++i){
+            if (i == 7) records.back() = ']';
+            if (write(fd, records.data(), records.size()) != static_cast<ssize_t>(records.size())) std::abort();
+            records.front() = ' ';
+        }
+        std::cout << "file: " << lseek(fd, 0, SEEK_END) / (1024 * 1024) << " MB" << std::endl;
+    }
+
+    run_isolated("stream", [&]{
+        auto begin = std::chrono::steady_clock::now();
+        CountingHandler handler;
+        JsonStream stream(handler);
+        std::string err;
+        char buf[64 * 1024];
+        lseek(fd, 0, SEEK_SET);
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof(buf))) > 0)
+            if (!stream.feed(buf, n, err)) std::abort();
+        if (!stream.finish(err)) std::abort();
+        std::cout << "stream: " << handler.values << " values in " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    run_isolated("read + parse", [&]{
+        auto begin = std::chrono::steady_clock::now();
+        std::string in(lseek(fd, 0, SEEK_END), '\0'), err;
+        if (pread(fd, &in[0], in.size(), 0) != static_cast<ssize_t>(in.size())) std::abort();
+        Json doc = Json::parse(in, err);
+        if (!err.empty()) std::abort();
+        std::cout << "read + parse: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    close(fd);
+    unlink(path);
+}
+
+//loading a read-only dataset: read() into a string and parse it, or parse the mapping in place
+void bench_files(){
+    char path[] = "/tmp/lxjson_files_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) std::abort();
+    {
+        std::string in = "[";
+        for (int i = 0; i < 200000; ++i){
+            if (i) in += ",";
+            in += "{\"id\":\"" + std::to_string(i) + "\",\"name\":\"reference record number " + std::to_string(i)
+                + "\",\"country\":\"somewhere\",\"tags\":[\"alpha\",\"beta\",\"gamma\"]}";
+        }
+        in += "]";
+        if (write(fd, in.data(), in.size()) != static_cast<ssize_t>(in.size())) std::abort();
+        std::cout << "file: " << in.size() / (1024 * 1024) << " MB" << std::endl;
+    }
+    close(fd);
+
+    run_isolated("read + parse", [&]{
+        auto begin = std::chrono::steady_clock::now();
+        FILE *f = fopen(path, "rb");
+        std::string in, err;
+        char buf[64 * 1024];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+            in.append(buf, n);
+        fclose(f);
+        Json doc = Json::parse(in, err);
+        if (!err.empty()) std::abort();
+        std::cout << "read + parse: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    run_isolated("parse_file", [&]{
+        auto begin = std::chrono::steady_clock::now();
+        std::string err;
+        Json doc = Json::parse_file(path, err);
+        if (!err.empty()) std::abort();
+        std::cout << "parse_file: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    run_isolated("parse_file with views", [&]{
+        auto begin = std::chrono::steady_clock::now();
+        std::string err;
+        Json doc = Json::parse_file(path, err, Json::StringStorage::VIEW);
+        if (!err.empty()) std::abort();
+        std::cout << "parse_file with views: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    unlink(path);
+}
+
+//key lookups in objects of 10, 100 and 10k keys, std::map against FlatObject
+template<typename Object>
+static void bench_lookups(const std::string &name, size_t n){
+    Object obj;
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; ++i){
+        keys.push_back("field_" + std::to_string(i * 7919 % n));
+        obj.emplace(keys.back(), Json(static_cast<int>(i)));
+    }
+    std::vector<std::string> order;
+    srand(3);
+    for (size_t i = 0; i < 100000; ++i)
+        order.push_back(keys[rand() % n]);
+    int64_t sum = 0;
+    double ns = bench(name + " lookups, " + std::to_string(n) + " keys", 10, [&]{
+        for (auto &key : order)
+            sum += obj.find(key)->second.int64_value();
+    });
+    std::cout << "  " << ns / order.size() << " ns/lookup" << std::endl;
+    if (!sum) std::abort();
+}
+
+void bench_objects(){
+    for (size_t n : {10, 100, 10000}){
+        bench_lookups<std::map<std::string, Json>>("std::map", n);
+        bench_lookups<FlatObject<Json>>("FlatObject", n);
+    }
+}
+
+//API responses: thousands of records with the same 20 keys. Build with `make benchmark_flat` to see
+//the interned keys of FlatObject, with std::map every entry keeps its own copy of the key
+void bench_keys(){
+    std::string in = "[";
+    for (int i = 0; i < 50000; ++i){
+        in += i ? ",{" : "{";
+        for (int k = 0; k < 20; ++k)
+            in += (k ? ",\"" : "\"") + std::string(k % 2 ? "attribute_number_" : "field_") + std::to_string(k) + "\":" + std::to_string(i + k);
+        in += "}";
+    }
+    in += "]";
+    std::cout << "document: " << in.size() / 1024 << " KB" << std::endl;
+
+    run_isolated("parse, keys per document", [&]{
+        std::string err;
+        auto begin = std::chrono::steady_clock::now();
+        Json doc = Json::parse(in, err);
+        std::cout << "parse, keys per document: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+    KeyTable keys(true);
+    run_isolated("parse, shared key table", [&]{
+        std::string err;
+        auto begin = std::chrono::steady_clock::now();
+        Json doc = Json::parse(in, err, keys);
+        std::cout << "parse, shared key table: " << elapsed_ms(begin) << " ms" << std::endl;
+    });
+
+    std::string err;
+    Json doc = Json::parse(in, err, keys);
+    const std::string name = "attribute_number_13";
+    JsonKey key = keys.intern(name);
+    int64_t sum = 0;
+    bench("operator[](std::string) over the records", 10, [&]{
+        for (auto &record : doc.array_value())
+            sum += record[name].int64_value();
+    });
+    bench("operator[](JsonKey) over the records", 10, [&]{
+        for (auto &record : doc.array_value())
+            sum += record[key].int64_value();
+    });
+    if (!sum) std::abort();
+}
+
+//time to first field: one value read out of a large document, then every record touched
+void bench_lazy(){
+    std::string in = "{\"meta\": {\"version\": 3}, \"records\": " + make_records(200000) + "}";
+    std::cout << "document: " << in.size() / 1024 << " KB" << std::endl;
+    std::string err;
+    int64_t sum = 0;
+    bench("eager parse + doc[\"meta\"][\"version\"]", 5, [&]{
+        Json doc = Json::parse(in, err);
+        sum += doc["meta"]["version"].int64_value();
+    });
+    bench("lazy parse + doc[\"meta\"][\"version\"]", 5, [&]{
+        Json doc = Json::parse(in, err, Json::ParseEngine::LAZY);
+        sum += doc["meta"]["version"].int64_value();
+    });
+    bench("lazy parse + doc[\"records\"][150000][\"id\"]", 5, [&]{
+        Json doc = Json::parse(in, err, Json::ParseEngine::LAZY);
+        sum += doc["records"][150000]["id"].int64_value();
+    });
+    bench("lazy parse + every record's \"id\"", 5, [&]{
+        Json doc = Json::parse(in, err, Json::ParseEngine::LAZY);
+        for (auto &record : doc["records"].array_value())
+            sum += record["id"].int64_value();
+    });
+    if (!sum || !err.empty()) std::abort();
+}
+
+void bench_paths(){
+    std::string in = "{\"meta\": {\"version\": 3}, \"records\": " + make_records(200000) + "}", err;
+    Json doc = Json::parse(in, err);
+    const std::string records = "records", name = "name";
+    size_t sum = 0;
+    bench("chained operator[]", 1000000, [&]{
+        sum += doc[records][123456][name].string_value().size();
+    });
+    JsonPath path("$.records[123456].name");
+    bench("compiled JsonPath::find", 1000000, [&]{
+        sum += path.find(doc)->string_value().size();
+    });
+    JsonPath ids("$.records[*].id");
+    bench("JsonPath::visit over 200k records", 10, [&]{
+        ids.visit(doc, [&](const Json &id){ sum += id.int64_value(); });
+    });
+    std::cout << "document: " << in.size() / 1024 << " KB" << std::endl;
+    bench("parse + find", 3, [&]{
+        Json tree = Json::parse(in, err);
+        sum += path.find(tree)->string_value().size();
+    });
+    bench("select on the text", 3, [&]{
+        sum += path.select(in, err)[0].string_value().size();
+    });
+    if (!sum || !err.empty()) std::abort();
+}
+
+//serializing string-heavy documents: log lines with a few escapes, and non-ASCII text in the three modes
+void bench_escape(){
+    std::string line = "GET /api/v1/items?id=12345&filter=active HTTP/1.1 200 - \"Mozilla/5.0 (X11; Linux x86_64)\"\tAppleWebKit/537.36";
+    std::string text = "Größenwahn, naïve café, 東京都, Ελληνικά, emoji \xF0\x9F\x98\x80 and plain ASCII words in between";
+    Json::array logs, prose;
+    for (int i = 0; i < 20000; ++i){
+        logs.push_back(Json(Json::object{{"message", Json(line)}, {"host", Json("frontend-" + std::to_string(i % 16))}}));
+        prose.push_back(Json(text));
+    }
+    Json l(std::move(logs)), p(std::move(prose));
+    size_t size = l.serialized_size();
+    double ns = bench("log records", 20, [&]{
+        std::string out = l.serialize();
+        if (out.size() != size) std::abort();
+    });
+    std::cout << "  " << size / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    SerializeOptions options;
+    for (auto mode : {SerializeOptions::Unicode::PASS, SerializeOptions::Unicode::VALIDATE, SerializeOptions::Unicode::ESCAPE}){
+        options.unicode = mode;
+        const char *name = mode == SerializeOptions::Unicode::PASS ? "non-ASCII text, passed through"
+                         : mode == SerializeOptions::Unicode::VALIDATE ? "non-ASCII text, validated" : "non-ASCII text, escaped";
+        size = p.serialized_size(options);
+        ns = bench(name, 20, [&]{
+            std::string out = p.serialize(options);
+            if (out.size() != size) std::abort();
+        });
+        std::cout << "  " << size / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    }
+}
+
+//the layouts of SerializeOptions on the same records, sorted keys cost one sort per object
+void bench_styles(){
+    std::string err;
+    Json records = Json::parse(make_records(200000), err);
+    SerializeOptions options;
+    const struct { const char *name; SerializeOptions::Style style; bool sort_keys; } cases[] = {
+        {"default", SerializeOptions::Style::DEFAULT, false},
+        {"compact", SerializeOptions::Style::COMPACT, false},
+        {"pretty", SerializeOptions::Style::PRETTY, false},
+        {"compact, sorted keys", SerializeOptions::Style::COMPACT, true},
+    };
+    for (auto &c : cases){
+        options.style = c.style;
+        options.sort_keys = c.sort_keys;
+        size_t size = records.serialized_size(options);
+        double ns = bench(c.name, 5, [&]{
+            std::string out = records.serialize(options);
+            if (out.size() != size) std::abort();
+        });
+        std::cout << "  " << size / 1024 << " KB, " << size / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    }
+}
+
+//internal hops: CBOR against the text for the encoding, the decoding and the size
+void bench_cbor(){
+    std::string err;
+    Json::array doubles, logs;
+    for (int i = 0; i < 200000; ++i){
+        doubles.push_back(Json(rand() / (double)RAND_MAX * 360 - 180));
+        logs.push_back(Json(Json::object{{"level", Json("info")}, {"ts", Json(static_cast<int64_t>(1700000000000LL + i))},
+                                         {"message", Json("request served in " + std::to_string(i % 977) + " ms by worker " + std::to_string(i % 16))}}));
+    }
+    const std::pair<const char *, Json> docs[] = {
+        {"records", Json::parse(make_records(200000), err)},
+        {"doubles", Json(std::move(doubles))},
+        {"log lines", Json(std::move(logs))},
+    };
+    for (auto &doc : docs){
+        std::string text = doc.second.serialize(), cbor = doc.second.to_cbor();
+        std::cout << doc.first << ": text " << text.size() / 1024 << " KB, CBOR " << cbor.size() / 1024 << " KB" << std::endl;
+        size_t sum = 0;
+        bench("  serialize + parse", 5, [&]{
+            std::string out = doc.second.serialize();
+            sum += Json::parse(out, err).is_null();
+        });
+        bench("  to_cbor + from_cbor", 5, [&]{
+            std::string out = doc.second.to_cbor();
+            sum += Json::from_cbor(out, err).is_null();
+        });
+        if (sum || Json::from_cbor(cbor, err) != doc.second) std::abort();
+    }
+}
+
+//NDJSON logs: the loop over Json::parse that NdjsonReader replaces, then the reader on 1 to N threads
+void bench_ndjson(){
+    std::string in;
+    for (int i = 0; i < 200000; ++i)
+        in += R"({"ts": )" + std::to_string(1700000000000LL + i) + R"(, "level": "info", "host": "frontend-)" + std::to_string(i % 16)
+            + R"(", "message": "request served in )" + std::to_string(i % 977) + R"( ms", "tags": ["http", "v1"], "latency": )"
+            + std::to_string(i * 0.001) + "}\n";
+    std::cout << "input: " << in.size() / (1024 * 1024) << " MB, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+    std::atomic<size_t> count(0);
+    double ns = bench("split + Json::parse per line", 3, [&]{
+        std::string line, err;
+        for (size_t at = 0; at < in.size(); ){
+            size_t newline = in.find('\n', at);
+            line.assign(in, at, newline - at);
+            count += Json::parse(line, err).is_object();
+            at = newline + 1;
+        }
+    });
+    std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (bool ordered : {true, false}){
+        for (unsigned threads = 1; ; threads = std::min(threads * 2, cores)){
+            NdjsonOptions options;
+            options.threads = threads;
+            options.ordered = ordered;
+            NdjsonReader reader(options);
+            std::string name = std::string(ordered ? "ordered" : "unordered") + ", " + std::to_string(threads) + " threads";
+            ns = bench(name, 3, [&]{
+                reader.read(in, [&](NdjsonRecord &record){
+                    count.fetch_add(record.value.is_object(), std::memory_order_relaxed);
+                    return true;
+                });
+            });
+            std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+            if (threads == cores) break;
+        }
+    }
+    if (!count) std::abort();
+}
+
+//one huge top-level array: the serial parser, then parse_parallel on 1 to N threads
+void bench_parallel(){
+    std::string in = make_records(400000), err;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "input: " << in.size() / (1024 * 1024) << " MB, " << cores << " cores" << std::endl;
+    size_t count = 0;
+    double ns = bench("Json::parse", 3, [&]{
+        count += Json::parse(in, err).array_value().size();
+    });
+    std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, cores)){
+        ns = bench("parse_parallel, " + std::to_string(threads) + " threads", 3, [&]{
+            count += Json::parse_parallel(in, err, threads).array_value().size();
+        });
+        std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+        if (threads == cores) break;
+    }
+    if (!count || !err.empty()) std::abort();
+}
+
+//untrusted payloads, most of them damaged: a byte replaced or the text cut short, anywhere
+void bench_errors(){
+    std::string record = R"({"user": {"id": 18342, "name": "Müller", "roles": ["admin", "dev"]}, "items": [)";
+    for (int i = 0; i < 8; ++i)
+        record += (i ? ", " : "") + std::string(R"({"sku": "A-)") + std::to_string(i) + R"(", "qty": )" + std::to_string(i + 1)
+            + R"(, "price": )" + std::to_string(i * 1.25) + R"(, "tags": [true, null]})";
+    record += R"(], "note": "line\nbreak"})";
+    std::vector<std::string> valid(1000, record), malformed;
+    srand(7);
+    for (size_t i = 0; i < valid.size(); ++i){
+        std::string damaged = record;
+        size_t at = static_cast<size_t>(rand()) % record.size();
+        if (i % 4 == 0) damaged.resize(at);
+        else damaged[at] = "\"{}[],:x\\"[rand() % 9];
+        malformed.push_back(damaged);
+    }
+    std::cout << "record: " << record.size() << " bytes, " << malformed.size() << " per corpus" << std::endl;
+    size_t failures = 0;
+    for (auto *corpus : {&valid, &malformed}){
+        std::string what = corpus == &valid ? "valid" : "malformed";
+        bench(what + ", Json::parse(in, status)", 100, [&]{
+            ParseStatus status;
+            for (auto &in : *corpus){
+                Json::parse(in, status);
+                failures += !status.ok();
+            }
+        });
+        bench(what + ", Json::parse(in, err)", 100, [&]{
+            std::string err;
+            for (auto &in : *corpus){
+                err.clear();
+                Json::parse(in, err);
+                failures += !err.empty();
+            }
+        });
+    }
+    if (!failures) std::abort();
+}
+
+//the explicit stack of open containers: shallow documents must not pay for it, deep ones stay
+//within the limit, a hostile one is given up at the limit
+void bench_depth(){
+    std::string records = make_records(20000), small = R"({"id": 42, "tags": ["a", "b"], "pos": {"x": 1.5, "y": -2}})";
+    std::string deep;
+    for (int i = 0; i < 200; ++i)
+        deep += (i ? "," : "[") + std::string(500, '[') + "1" + std::string(500, ']');
+    deep += "]";
+    ParseOptions options;
+    options.max_depth = 501;
+    std::string hostile(1 << 20, '[');
+    size_t count = 0;
+    ParseStatus status;
+    double ns = bench("records, " + std::to_string(records.size() / 1024) + " KB", 20, [&]{
+        count += Json::parse(records, status).array_value().size();
+    });
+    std::cout << "  " << records.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    bench("small message, " + std::to_string(small.size()) + " bytes", 200000, [&]{
+        count += Json::parse(small, status).object_value().size();
+    });
+    ns = bench("200 arrays 500 deep", 20, [&]{
+        count += Json::parse(deep, status, options).array_value().size();
+    });
+    std::cout << "  " << deep.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    bench("1 MB of '[', rejected at the limit", 1000, [&]{
+        count += Json::parse(hostile, status).is_null();
+    });
+    if (!count) std::abort();
+}
+
+//a stream of small messages, one Json::parse per message against one parser for all of them
+void bench_parser(){
+    std::vector<std::string> messages;
+    for (int i = 0; i < 1000; ++i)
+        messages.push_back(R"({"id": )" + std::to_string(i) + R"(, "type": "order", "user": {"name": "M\u00fcller", "tier": 2},)"
+            + R"( "items": [{"sku": "A-1", "qty": 3}, {"sku": "B-22", "qty": 1}], "total": 41.5, "gift": false})");
+    std::cout << "message: " << messages[0].size() << " bytes" << std::endl;
+    size_t count = 0;
+    auto run = [&](const std::string &name, const std::function<Json(const std::string &)> &parse){
+        size_t before = alloc_count;
+        double ns = bench(name, 200, [&]{
+            for (auto &in : messages)
+                count += parse(in).object_value().size();
+        });
+        std::cout << "  " << ns / messages.size() << " ns/message, "
+            << static_cast<double>(alloc_count - before) / (200 * messages.size()) << " allocations/message" << std::endl;
+    };
+    ParseStatus status;
+    run("Json::parse", [&](const std::string &in){return Json::parse(in, status);});
+    Json::Parser parser;
+    run("Json::Parser", [&](const std::string &in){return parser.parse(in, status);});
+    Json::Parser arena_parser(4096);
+    run("Json::Parser with an arena", [&](const std::string &in){return arena_parser.parse(in, status);});
+    if (!count || !status.ok()) std::abort();
+}
+
+//the cost of ParseOptions::validate_utf8, on well-formed text and on text it rejects
+void bench_utf8(){
+    const char *words[] = {"order", "Müller", "café", "Привет", "мир", "東京都", "日本語の文章", "😀", "naïve", "€42"};
+    std::string ascii = "[", mixed = "[";
+    srand(11);
+    for (int i = 0; i < 5000; ++i){
+        std::string a, m;
+        for (int w = 0; w < 12; ++w){
+            a += std::string(w ? " " : "") + words[0];
+            m += std::string(w ? " " : "") + words[rand() % 10];
+        }
+        ascii += (i ? ", \"" : "\"") + a + "\"";
+        mixed += (i ? ", \"" : "\"") + m + "\"";
+    }
+    ascii += "]";
+    mixed += "]";
+    std::string text;
+    while (text.size() < (1 << 20)) text += words[rand() % 10];
+    std::string long_string = "\"" + text + "\"";
+    //one invalid byte near the end, the whole document is read before it is rejected
+    std::string truncated = mixed, stray = mixed;
+    truncated.insert(truncated.size() - 10, "\xE2\x82");
+    stray.insert(stray.size() - 10, "\xBF");
+    ParseOptions strict;
+    strict.validate_utf8 = true;
+    size_t count = 0;
+    ParseStatus status;
+    auto run = [&](const std::string &name, const std::string &in, const ParseOptions &options){
+        double ns = bench(name + ", " + std::to_string(in.size() / 1024) + " KB", 20, [&]{
+            count += !Json::parse(in, status, options).is_null();
+        });
+        std::cout << "  " << in.size() / ns * 1e9 / (1024 * 1024) << " MB/s" << std::endl;
+    };
+    ParseOptions defaults;
+    for (auto *options : {&defaults, &strict}){
+        std::string mode = options == &strict ? "validate_utf8" : "default";
+        run(mode + ", ASCII strings", ascii, *options);
+        run(mode + ", mixed scripts", mixed, *options);
+        run(mode + ", one long string", long_string, *options);
+    }
+    run("validate_utf8, truncated character near the end", truncated, strict);
+    if (status.error != ParseStatus::Error::INVALID_UTF8) std::abort();
+    run("validate_utf8, stray continuation byte near the end", stray, strict);
+    if (!count || status.error != ParseStatus::Error::INVALID_UTF8) std::abort();
+}
+
+//single-field updates of a large document: in place when it is owned alone, copying the shared
+//containers on the path when an older version is kept, against rebuilding that path by hand
+static Json make_level(size_t fanout, size_t depth){
+    Json::object members;
+    for (size_t i = 0; i < fanout; ++i)
+        members.emplace("k" + std::to_string(i), depth > 1 ? make_level(fanout, depth - 1) : Json(static_cast<int>(i)));
+    return Json(std::move(members));
+}
+
+static Json rebuild(const Json &node, const std::vector<std::string> &path, size_t at, Json value){
+    if (at == path.size()) return value;
+    Json::object members = node.object_value();
+    members[path[at]] = rebuild(node[path[at]], path, at + 1, std::move(value));
+    return Json(std::move(members));
+}
+
+void bench_edit(){
+    struct Shape{
+        const char *name;
+        size_t fanout, depth;
+    };
+    for (const Shape &shape : {Shape{"wide, 1000 x 50", 0, 0}, Shape{"deep, 8^5", 8, 5}}){
+        Json doc;
+        if (shape.fanout) doc = make_level(shape.fanout, shape.depth);
+        else {
+            Json::object sections;
+            for (int i = 0; i < 1000; ++i) sections.emplace("k" + std::to_string(i), make_level(50, 1));
+            doc = Json(std::move(sections));
+        }
+        size_t depth = shape.fanout ? shape.depth : 2, fanout = shape.fanout ? shape.fanout : 50;
+        std::vector<std::vector<std::string>> paths;
+        srand(5);
+        for (int i = 0; i < 1000; ++i){
+            std::vector<std::string> path;
+            for (size_t level = 0; level < depth; ++level)
+                path.push_back("k" + std::to_string(rand() % (level || shape.fanout ? fanout : 1000)));
+            paths.push_back(path);
+        }
+        std::cout << shape.name << ": " << doc.serialized_size() / 1024 << " KB" << std::endl;
+        int64_t sum = 0;
+        auto run = [&](const std::string &name, const std::function<void(const std::vector<std::string> &, int)> &update){
+            size_t before = alloc_count;
+            double ns = bench(std::string(shape.name) + ", " + name, 20, [&]{
+                int i = 0;
+                for (auto &path : paths) update(path, i++);
+            });
+            std::cout << "  " << ns / paths.size() << " ns/update, "
+                << static_cast<double>(alloc_count - before) / (20 * paths.size()) << " allocations/update" << std::endl;
+        };
+        run("in place", [&](const std::vector<std::string> &path, int i){
+            Json *node = &doc;
+            for (auto &key : path) node = &node->edit(key);
+            *node = Json(i);
+        });
+        Json snapshot;
+        run("path copy, an older version kept", [&](const std::vector<std::string> &path, int i){
+            snapshot = doc;
+            Json *node = &doc;
+            for (auto &key : path) node = &node->edit(key);
+            *node = Json(i);
+        });
+        run("rebuilt by hand", [&](const std::vector<std::string> &path, int i){
+            snapshot = doc;
+            doc = rebuild(doc, path, 0, Json(i));
+        });
+        for (auto &path : paths){
+            const Json *node = &doc;
+            for (auto &key : path) node = &(*node)[key];
+            sum += node->int_value();
+        }
+        if (!sum) std::abort();
+    }
+}
+
+struct Benchmark{
+    const char *name;
+    void (*fn)();
+};
+
+static const Benchmark benchmarks[] = {
+    {"copy", bench_copy},
+    {"arena", bench_arena},
+    {"access", bench_access},
+    {"strings", bench_strings},
+    {"engines", bench_engines},
+    {"numbers", bench_numbers},
+    {"serialize", bench_serialize},
+    {"stream", bench_stream},
+    {"files", bench_files},
+    {"objects", bench_objects},
+    {"keys", bench_keys},
+    {"lazy", bench_lazy},
+    {"paths", bench_paths},
+    {"escape", bench_escape},
+    {"styles", bench_styles},
+    {"cbor", bench_cbor},
+    {"ndjson", bench_ndjson},
+    {"parallel", bench_parallel},
+    {"errors", bench_errors},
+    {"depth", bench_depth},
+    {"parser", bench_parser},
+    {"utf8", bench_utf8},
+    {"edit", bench_edit},
+};
+
+//usage: benchmark [name...], runs every benchmark when no name is given
+int main(int argc, char **argv)
+{
+    for (auto &b : benchmarks){
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected = selected || !strcmp(argv[i], b.name);
+        if (!selected) continue;
+        std::cout << "== " << b.name << std::endl;
+        b.fn();
+    }
+    return 0;
+}
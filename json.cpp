@@ -1,10 +1,29 @@
 #include "json.hpp"
 #include <cstdio>
+#include <cerrno>
 #include <stdexcept> //for runtime error
 #include <cstring>
 #include <iostream>
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cfloat>
+#include <sstream>
+#include <locale>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define LXJSON_X86_SIMD 1
+#include <immintrin.h>
+#endif
 
 namespace lxjson{
 
@@ -14,81 +33,397 @@ using std::map;
 
 static const Json json_null; // internal linkage
 
-static void serialize(std::nullptr_t, string &out){
-    out+="null";
+//Output of the serializer: straight into a buffer sized with Json::serialized_size(), or through a
+//block of its own, handed to a JsonSink whenever it is full
+class JsonWriter final {
+public:
+    JsonWriter(char *begin, char *end, const SerializeOptions &options)
+        : m_pos(begin), m_end(end), m_sink(nullptr), m_options(options){}
+    JsonWriter(JsonSink &sink, const SerializeOptions &options)
+        : m_pos(m_block), m_end(m_block + block_size), m_sink(&sink), m_options(options){}
+
+    const SerializeOptions &options() const{
+        return m_options;
+    }
+
+    //room for n more characters (n <= block_size) at the returned position, give the end to commit()
+    char *reserve(size_t n){
+        if (static_cast<size_t>(m_end - m_pos) < n) flush();
+        return m_pos;
+    }
+    void commit(char *pos){
+        m_pos = pos;
+    }
+    void put(char c){
+        *reserve(1) = c;
+        ++m_pos;
+    }
+    void put(const char *data, size_t size){
+        if (static_cast<size_t>(m_end - m_pos) < size){
+            flush();
+            if (size > block_size){
+                m_ok = m_ok && m_sink->write(data, size);
+                return;
+            }
+        }
+        memcpy(m_pos, data, size);
+        m_pos += size;
+    }
+    const char *position() const{
+        return m_pos;
+    }
+    //hand what is left to the sink, false when a write failed
+    bool finish(){
+        if (m_sink) flush();
+        return m_ok;
+    }
+
+    //the whole document, in the style of the options
+    void write_document(const Json &value);
+    //length of the output, or with Exact false, an upper bound that does not format the doubles
+    template<bool Exact>
+    static size_t document_size(const Json &value, const SerializeOptions &options);
+
+    //how a Json value is written, it needs the private parts
+    template<typename Style>
+    static void write(const Json &value, JsonWriter &out, unsigned depth){
+        value.write<Style>(out, depth);
+    }
+    template<bool Exact, typename Style>
+    static size_t size(const Json &value, const SerializeOptions &options, unsigned depth);
+
+private:
+    static const size_t block_size = 1 << 14;
+
+    void flush(){
+        if (!m_sink) throw std::runtime_error("serialized_size() is wrong"); //never with a buffer of the right size
+        if (m_ok && m_pos != m_block) m_ok = m_sink->write(m_block, static_cast<size_t>(m_pos - m_block));
+        m_pos = m_block;
+    }
+
+    char *m_pos;
+    char *m_end;
+    JsonSink *m_sink;
+    SerializeOptions m_options;
+    bool m_ok = true;
+    char m_block[block_size];
+};
+
+static void serialize(std::nullptr_t, JsonWriter &out){
+    out.put("null", 4);
 }
-static void serialize(int values, string &out){
-    char c[32];
-    snprintf(c, sizeof(c), "%d", values);
-    out += c;
+//number formatting, defined next to the number parser below
+static inline unsigned decimal_length(uint64_t v);
+static inline char *write_uint64(uint64_t v, bool negative, char *dst);
+static char *write_double(double value, char *dst);
+
+static void serialize(int64_t values, JsonWriter &out){
+    uint64_t magnitude = values < 0 ? 0 - static_cast<uint64_t>(values) : static_cast<uint64_t>(values);
+    out.commit(write_uint64(magnitude, values < 0, out.reserve(21)));
 }
-static void serialize(double values, string &out){
-    char c[32];
-    snprintf(c, sizeof(c), "%.17g", values);
-    out += c;
+static void serialize(uint64_t values, JsonWriter &out){
+    out.commit(write_uint64(values, false, out.reserve(20)));
 }
-static void serialize(bool values, string &out){
-    out += values? "true":"false";
+static void serialize(double values, JsonWriter &out){
+    out.commit(write_double(values, out.reserve(25)));
 }
-static void serialize(const string &values, string &out){
-    out += "\"";
-    for(auto e : values){
-        switch(e){
-            case '\"':
-                out += "\\\"";
-                break;
-            case '\\':
-                out += "\\\\";
-                break;
-            case '\b':
-                out += "\\b";
-                break;
-            case '\f':
-                out += "\\f";
-                break;
-            case '\n':
-                out += "\\n";
-                break;
-            case '\r':
-                out += "\\r";
-                break;
-            case '\t':
-                out += "\\t";
-                break;
-            default:
-                if (static_cast<unsigned char>(e) < 0x20) {
-                    char buf[7];
-                    sprintf(buf, "\\u%04X", e);
-                    out += buf;
-                } 
-                else
-                    out += e;
+static void serialize(bool values, JsonWriter &out){
+    if (values) out.put("true", 4);
+    else out.put("false", 5);
+}
+//the scanners of the parser, defined with it below: the end of a span without '"', '\\' or control
+//characters, and of a span of such ASCII characters only
+static const char *scan_plain(const char *p, const char *end);
+static const char *scan_plain_ascii(const char *p, const char *end);
+
+//the escape of each ASCII character, 0 when it is written as it is, 'u' for a \u00XX escape
+static const char escape_table[128] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+//the code point of the UTF-8 sequence at p and its end, nullptr when it is not well formed:
+//truncated, overlong, a surrogate or above U+10FFFF
+static const char *decode_utf8(const char *p, const char *end, uint32_t &code){
+    unsigned char lead = static_cast<unsigned char>(*p);
+    int extra;
+    uint32_t min;
+    if (lead >= 0xC2 && lead <= 0xDF){ extra = 1; code = lead & 0x1F; min = 0x80; }
+    else if ((lead & 0xF0) == 0xE0)  { extra = 2; code = lead & 0x0F; min = 0x800; }
+    else if (lead >= 0xF0 && lead <= 0xF4){ extra = 3; code = lead & 0x07; min = 0x10000; }
+    else return nullptr;
+    if (end - p <= extra) return nullptr;
+    for (int i = 1; i <= extra; ++i){
+        unsigned char c = static_cast<unsigned char>(p[i]);
+        if ((c & 0xC0) != 0x80) return nullptr;
+        code = code << 6 | (c & 0x3F);
+    }
+    if (code < min || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return nullptr;
+    return p + extra + 1;
+}
+
+//the UTF-8 form of a code point up to U+10FFFF
+static void append_utf8(uint32_t code, string &out){
+    char bytes[4];
+    size_t size;
+    if (code < 0x80){ bytes[0] = static_cast<char>(code); size = 1; }
+    else if (code < 0x800){
+        bytes[0] = static_cast<char>(0xC0 | code >> 6);
+        bytes[1] = static_cast<char>(0x80 | (code & 0x3F));
+        size = 2;
+    }
+    else if (code < 0x10000){
+        bytes[0] = static_cast<char>(0xE0 | code >> 12);
+        bytes[1] = static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        bytes[2] = static_cast<char>(0x80 | (code & 0x3F));
+        size = 3;
+    }
+    else {
+        bytes[0] = static_cast<char>(0xF0 | code >> 18);
+        bytes[1] = static_cast<char>(0x80 | (code >> 12 & 0x3F));
+        bytes[2] = static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        bytes[3] = static_cast<char>(0x80 | (code & 0x3F));
+        size = 4;
+    }
+    out.append(bytes, size);
+}
+
+static char *write_u_escape(uint32_t unit, char *dst){
+    static const char hex[] = "0123456789ABCDEF";
+    dst[0] = '\\';
+    dst[1] = 'u';
+    dst[2] = hex[unit >> 12 & 0xF];
+    dst[3] = hex[unit >> 8 & 0xF];
+    dst[4] = hex[unit >> 4 & 0xF];
+    dst[5] = hex[unit & 0xF];
+    return dst + 6;
+}
+
+//clean spans are found by the SIMD scanners and copied whole, the rest goes through the table
+static void serialize(StringView values, JsonWriter &out){
+    using Unicode = SerializeOptions::Unicode;
+    const Unicode unicode = out.options().unicode;
+    const char *p = values.data, *end = values.data + values.size;
+    out.put('"');
+    while (true){
+        const char *span_end = unicode == Unicode::PASS ? scan_plain(p, end) : scan_plain_ascii(p, end);
+        out.put(p, static_cast<size_t>(span_end - p));
+        if (span_end == end) break;
+        unsigned char c = static_cast<unsigned char>(*span_end);
+        if (c < 0x80){
+            char *dst = out.reserve(6);
+            if (escape_table[c] == 'u')
+                dst = write_u_escape(c, dst);
+            else {
+                dst[0] = '\\';
+                dst[1] = escape_table[c];
+                dst += 2;
+            }
+            out.commit(dst);
+            p = span_end + 1;
+            continue;
         }
+        uint32_t code;
+        p = decode_utf8(span_end, end, code);
+        if (!p) throw std::runtime_error("invalid UTF-8 in a string");
+        if (unicode == Unicode::VALIDATE){
+            out.put(span_end, static_cast<size_t>(p - span_end));
+            continue;
+        }
+        char *dst = out.reserve(12);
+        if (code > 0xFFFF){
+            code -= 0x10000;
+            dst = write_u_escape(0xD800 + (code >> 10), dst);
+            code = 0xDC00 + (code & 0x3FF);
+        }
+        out.commit(write_u_escape(code, dst));
     }
-    out += "\"";
+    out.put('"');
+}
+static void serialize(const string &values, JsonWriter &out){
+    serialize(StringView{values.data(), values.size()}, out);
+}
+#ifdef LXJSON_FLAT_OBJECT
+static void serialize(const JsonKey &values, JsonWriter &out){
+    serialize(values.str(), out);
 }
-static void serialize(const Json::array &values, string &out){
+#endif
+
+//Styles of SerializeOptions: the container loops are instantiated for each of them, so that they
+//don't test the options on every element. separator() comes before every element, close() before
+//the closing bracket of a non-empty container, and container_size() counts the brackets, separators
+//and whitespace of a container of n elements.
+struct DefaultStyle{
+    static void separator(JsonWriter &out, unsigned, bool first){
+        if (!first) out.put(", ", 2);
+    }
+    static void close(JsonWriter &, unsigned){}
+    static void colon(JsonWriter &out){
+        out.put(": ", 2);
+    }
+    static size_t container_size(size_t n, unsigned, unsigned){
+        return n ? 2 * n : 2;
+    }
+    static const size_t colon_size = 2;
+};
+
+struct CompactStyle{
+    static void separator(JsonWriter &out, unsigned, bool first){
+        if (!first) out.put(',');
+    }
+    static void close(JsonWriter &, unsigned){}
+    static void colon(JsonWriter &out){
+        out.put(':');
+    }
+    static size_t container_size(size_t n, unsigned, unsigned){
+        return n ? n + 1 : 2;
+    }
+    static const size_t colon_size = 1;
+};
+
+struct PrettyStyle{
+    static void newline(JsonWriter &out, unsigned depth){
+        static const char spaces[] = "                                                                ";
+        out.put('\n');
+        for (size_t n = static_cast<size_t>(depth) * out.options().indent; n; ){
+            size_t chunk = std::min(n, sizeof(spaces) - 1);
+            out.put(spaces, chunk);
+            n -= chunk;
+        }
+    }
+    static void separator(JsonWriter &out, unsigned depth, bool first){
+        if (!first) out.put(',');
+        newline(out, depth);
+    }
+    static void close(JsonWriter &out, unsigned depth){
+        newline(out, depth);
+    }
+    static void colon(JsonWriter &out){
+        out.put(": ", 2);
+    }
+    static size_t container_size(size_t n, unsigned depth, unsigned indent){
+        if (!n) return 2;
+        return 2 + (n - 1) + n * (1 + static_cast<size_t>(indent) * (depth + 1)) + 1 + static_cast<size_t>(indent) * depth;
+    }
+    static const size_t colon_size = 2;
+};
+
+template<typename Style>
+static void serialize(const Json::array &values, JsonWriter &out, unsigned depth){
+    out.put('[');
+    if (values.empty()){
+        out.put(']');
+        return;
+    }
     bool isFirst = true;
-    out += "[";
     for (auto &value: values){
-        if (!isFirst) out += ", ";
-        value.serialize(out);
+        Style::separator(out, depth + 1, isFirst);
+        JsonWriter::write<Style>(value, out, depth + 1);
         isFirst = false;
     }
-    out += "]";
+    Style::close(out, depth);
+    out.put(']');
 }
-static void serialize(const Json::object &values, string &out){
-    bool isFirst = true;
-    out += "{";
-    for (const std::pair<string, Json> &value : values){
-        if (!isFirst) 
-            out += ", ";
-        serialize(value.first, out);
-        out += ": ";
-        value.second.serialize(out);
-        isFirst = false;
+
+template<typename Style>
+static void serialize_member(const Json::object::value_type &member, JsonWriter &out, unsigned depth, bool first){
+    Style::separator(out, depth + 1, first);
+    serialize(member.first, out);
+    Style::colon(out);
+    JsonWriter::write<Style>(member.second, out, depth + 1);
+}
+
+template<typename Style>
+static void serialize(const Json::object &values, JsonWriter &out, unsigned depth){
+    out.put('{');
+    if (values.empty()){
+        out.put('}');
+        return;
+    }
+#ifdef LXJSON_FLAT_OBJECT
+    if (out.options().sort_keys){
+        vector<const Json::object::value_type *> sorted;
+        sorted.reserve(values.size());
+        for (auto &member : values) sorted.push_back(&member);
+        std::sort(sorted.begin(), sorted.end(), [](const Json::object::value_type *a, const Json::object::value_type *b){
+            return a->first < b->first;
+        });
+        for (size_t i = 0; i < sorted.size(); ++i)
+            serialize_member<Style>(*sorted[i], out, depth, i == 0);
+    }
+    else
+#endif
+    {
+        bool isFirst = true;
+        for (const Json::object::value_type &value : values){
+            serialize_member<Style>(value, out, depth, isFirst);
+            isFirst = false;
+        }
+    }
+    Style::close(out, depth);
+    out.put('}');
+}
+
+//what the serializer writes for a string, quotes included
+static size_t serialized_size(StringView values, const SerializeOptions &options){
+    const bool escape_unicode = options.unicode == SerializeOptions::Unicode::ESCAPE;
+    const char *p = values.data, *end = values.data + values.size;
+    size_t size = values.size + 2;
+    while (true){
+        p = escape_unicode ? scan_plain_ascii(p, end) : scan_plain(p, end);
+        if (p == end) return size;
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c < 0x80){
+            size += escape_table[c] == 'u' ? 5 : 1;
+            ++p;
+            continue;
+        }
+        //\uXXXX, or two of them, in place of the 2 to 4 bytes of the sequence
+        uint32_t code;
+        const char *next = decode_utf8(p, end, code);
+        if (!next){
+            ++p; //serialize() throws
+            continue;
+        }
+        size += (code > 0xFFFF ? 12 : 6) - static_cast<size_t>(next - p);
+        p = next;
+    }
+}
+
+//Sinks
+bool StringSink::write(const char *data, size_t size){
+    m_out.append(data, size);
+    return true;
+}
+
+bool BufferSink::write(const char *data, size_t size){
+    if (size > m_capacity - m_size) return false;
+    memcpy(m_data + m_size, data, size);
+    m_size += size;
+    return true;
+}
+
+bool FileSink::write(const char *data, size_t size){
+    return fwrite(data, 1, size, m_file) == size;
+}
+
+bool FdSink::write(const char *data, size_t size){
+    while (size){
+        ssize_t n = ::write(m_fd, data, size);
+        if (n < 0){
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
     }
-    out += "}";
+    return true;
 }
 
 //一般情况下不会产生函数本身的代码，而是全部被嵌入在被调用的地方，减小可执行文件
@@ -96,365 +431,2759 @@ static inline bool in_range(int x, int lower, int upper){
     return (x >= lower && x <= upper);
 }
 
-//JsonValue
-double JsonValue::double_value() const               {throw std::runtime_error("not a number!");}
-int JsonValue::int_value() const                     {throw std::runtime_error("not a number!");}
-const string &JsonValue::string_value() const        {throw std::runtime_error("not a string!");}
-bool JsonValue::bool_value() const                   {throw std::runtime_error("not a boolean!");}
-const Json::array &JsonValue::array_value() const    {throw std::runtime_error("not a array!");}
-const Json::object &JsonValue::object_value() const  {throw std::runtime_error("not a object!");}
+static_assert(sizeof(Json) == 16, "Json must stay a 16-byte tagged value");
 
-const Json &JsonValue::operator[](size_t i) const{
-    throw std::runtime_error("not an array");
+//Arena
+Arena::Arena(size_t chunk_size)
+    : m_chunks(nullptr), m_cur(nullptr), m_end(nullptr), m_chunk_size(chunk_size), m_used(0), m_reserved(0), m_nodes(0){}
+
+Arena::~Arena(){
+    while (m_chunks){
+        Chunk *next = m_chunks->next;
+        ::operator delete(m_chunks);
+        m_chunks = next;
+    }
 }
 
-const Json &JsonValue::operator[](const std::string key) const{
-    throw std::runtime_error("not an object");
+void *Arena::allocate(size_t size, size_t align){
+    uintptr_t cur = reinterpret_cast<uintptr_t>(m_cur);
+    uintptr_t aligned = (cur + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    if (!m_cur || aligned + size > reinterpret_cast<uintptr_t>(m_end)){
+        //oversized requests get a chunk of their own
+        size_t payload = std::max(m_chunk_size, size + align);
+        size_t header = chunk_header();
+        Chunk *chunk = static_cast<Chunk *>(::operator new(header + payload));
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+        m_reserved += header + payload;
+        m_cur = reinterpret_cast<char *>(chunk) + header;
+        m_end = m_cur + payload;
+        cur = reinterpret_cast<uintptr_t>(m_cur);
+        aligned = (cur + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    }
+    m_cur = reinterpret_cast<char *>(aligned + size);
+    m_used += size;
+    return reinterpret_cast<void *>(aligned);
 }
 
-template<Json::JsonType tag, typename T>
-class Value: public JsonValue{
-protected:
-    Value(const T& value):m_value(value){}
-    Value(T &&value):m_value(std::move(value)){}
+size_t Arena::chunk_header(){
+    return (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
 
-    Json::JsonType type() const{
-        return tag;
+void Arena::rewind(){
+    if (!m_chunks) return;
+    //the newest chunk is the one being filled, m_end is its end
+    while (Chunk *older = m_chunks->next){
+        m_chunks->next = older->next;
+        ::operator delete(older);
     }
+    m_cur = reinterpret_cast<char *>(m_chunks) + chunk_header();
+    m_reserved = static_cast<size_t>(m_end - reinterpret_cast<char *>(m_chunks));
+    m_used = 0;
+}
+
+//Keys
+KeyTable::~KeyTable(){
+    for (auto &shard : m_shards)
+        for (JsonKey::Rep *rep : shard.slots)
+            JsonKey::release(rep);
+}
 
-    //reinterpret_cast only guarantees that if you cast a pointer to a different type, and then reinterpret_cast it back to the original type
-    bool equals(const JsonValue * other) const {
-        return m_value == reinterpret_cast<const Value<tag, T> *>(other)->m_value;
+JsonKey KeyTable::intern(const char *data, size_t size){
+    size_t h = key_hash(data, size);
+    //the shard from the high bits, the slot from the low ones
+    Shard &shard = m_shards[m_shared ? (h >> 59) % shard_count : 0];
+    std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+    if (m_shared) lock.lock();
+    if (shard.slots.size() < 2 * (shard.size + 1)){
+        std::vector<JsonKey::Rep *> slots(std::max<size_t>(16, 2 * shard.slots.size()), nullptr);
+        for (JsonKey::Rep *rep : shard.slots){
+            if (!rep) continue;
+            size_t s = rep->hash & (slots.size() - 1);
+            while (slots[s]) s = (s + 1) & (slots.size() - 1);
+            slots[s] = rep;
+        }
+        shard.slots.swap(slots);
     }
-    bool less(const JsonValue * other) const {
-        return m_value < reinterpret_cast<const Value<tag, T> *>(other)->m_value;
+    size_t mask = shard.slots.size() - 1;
+    for (size_t s = h & mask; ; s = (s + 1) & mask){
+        JsonKey::Rep *rep = shard.slots[s];
+        if (!rep){
+            rep = new JsonKey::Rep(string(data, size));
+            shard.slots[s] = rep;
+            ++shard.size;
+        }
+        else if (rep->hash != h || rep->value.size() != size || memcmp(rep->value.data(), data, size))
+            continue;
+        rep->refs.fetch_add(1, std::memory_order_relaxed);
+        return JsonKey(rep);
     }
+}
 
-    virtual void serialize(std::string& out) const{
-        lxjson::serialize(m_value, out);
-    }
+size_t KeyTable::size() const{
+    size_t total = 0;
+    for (auto &shard : m_shards)
+        total += shard.size;
+    return total;
+}
 
 
-    const T m_value;
+//Nodes: the out-of-line part of strings, arrays and objects.
+//They are shared between copies through an intrusive count, only their sole owner edits them (see detach()).
+struct JsonNode{
+    std::atomic<size_t> refs;
+    Arena *arena; //nullptr when the node lives on the heap
+
+    explicit JsonNode(Arena *arena) : refs(1), arena(arena){}
 };
 
-//Type: number
-class JsonInt final : public Value<Json::JsonType::T_NUMBER, int>{
-public:
-    int int_value() const {return m_value;}//cast
-    double double_value() const {return m_value;}
-    bool equals(const JsonValue * other) const { return m_value == other->double_value(); }
-    bool less(const JsonValue * other)   const { return m_value <  other->double_value(); }
+template<typename T>
+struct ValueNode final : JsonNode{
+    template<typename... Args>
+    explicit ValueNode(Arena *arena, Args&&... args) : JsonNode(arena), m_value(std::forward<Args>(args)...){}
 
-    JsonInt(double value):Value(value){}
+    T m_value;
 };
 
-class JsonDouble final : public Value<Json::JsonType::T_NUMBER, double>{
-public:
-    int int_value() const {return m_value;}//cast
-    double double_value() const {return m_value;}
-    bool equals(const JsonValue * other) const { return m_value == other->double_value(); }
-    bool less(const JsonValue * other)   const { return m_value <  other->double_value(); }
+using StringNode = ValueNode<string>;
+using ArrayNode  = ValueNode<Json::array>;
+using ObjectNode = ValueNode<Json::object>;
 
-    JsonDouble(double value):Value(value){}
-};
+//characters owned by someone else (the arena's backing buffer), copied the first time a
+//std::string is asked for; concurrent readers may race to build it, only one copy is kept
+struct ViewNode final : JsonNode{
+    ViewNode(Arena *arena, const char *data, size_t size) : JsonNode(arena), m_data(data), m_size(size), m_copy(nullptr){}
+    ~ViewNode(){delete m_copy.load(std::memory_order_acquire);}
 
-//Type: bool
-class JsonBool final : public Value<Json::JsonType::T_BOOL, bool>{
-public:
-    bool bool_value() const {return m_value;}
+    const string &str() const{
+        string *copy = m_copy.load(std::memory_order_acquire);
+        if (!copy){
+            string *fresh = new string(m_data, m_size);
+            if (m_copy.compare_exchange_strong(copy, fresh, std::memory_order_acq_rel))
+                copy = fresh;
+            else
+                delete fresh;
+        }
+        return *copy;
+    }
 
-    JsonBool(bool value): Value(value){}
+    const char *m_data;
+    size_t m_size;
+    mutable std::atomic<string *> m_copy;
 };
 
-//Type string
-class JsonString final : public Value<Json::JsonType::T_STRING, string>{
-public:
-    const string &string_value() const {return m_value;}
+//text of a lazily parsed document, validated, with the extent of every array and object found on
+//the way, in the order they open: building a container jumps over the nested ones without reading them
+struct LazySource{
+    struct Extent{
+        const char *end;   //one past the closing bracket
+        size_t next;       //index of the first container after this one and everything inside it
+    };
 
-    JsonString(const string &value): Value(value){}
-    JsonString(string &&value): Value(std::move(value)){}
+    string text;
+    vector<Extent> extents;
 };
 
-class JsonArray final : public Value<Json::JsonType::T_ARRAY, Json::array> {
-public:
-    const Json::array &array_value() const {return m_value;}
-    const Json &operator[](size_t i) const {
-        if (i >= m_value.size()) return json_null;
-        return m_value[i];
-    }
+//array or object of a lazily parsed document, built one level deep the first time it is accessed,
+//the nested containers being lazy in turn. Like ViewNode::str(), concurrent readers may race to
+//build it, only one result is kept.
+struct LazyNode final : JsonNode{
+    LazyNode(Arena *arena, std::shared_ptr<const LazySource> source, const char *begin, size_t index)
+        : JsonNode(arena), m_source(std::move(source)), m_begin(begin), m_index(index), m_value(nullptr){}
+    ~LazyNode(){delete m_value.load(std::memory_order_acquire);}
 
-    JsonArray(const Json::array &value): Value(value){}
-    JsonArray(Json::array &&value): Value(std::move(value)){}
+    const Json &value() const; //after jParser
+
+    std::shared_ptr<const LazySource> m_source;
+    const char *m_begin;
+    size_t m_index; //in m_source->extents
+    mutable std::atomic<Json *> m_value;
 };
 
-class JsonObject final : public Value<Json::JsonType::T_OBJECT, Json::object> {
-public:
-    const Json::object &object_value() const{
-        return m_value;
+template<typename T, typename... Args>
+Json Json::make_node(Kind kind, Arena *arena, Args&&... args){
+    if (!arena)
+        return Json(kind, new T(nullptr, std::forward<Args>(args)...));
+    T *node = new (arena->allocate(sizeof(T), alignof(T))) T(arena, std::forward<Args>(args)...);
+    arena->m_nodes.fetch_add(1, std::memory_order_relaxed);
+    return Json(kind, node);
+}
+
+template<typename T>
+static void destroy_node(JsonNode *base){
+    T *node = static_cast<T *>(base);
+    if (node->arena)
+        node->~T(); //the memory goes back with the whole arena, only the payload is released here
+    else
+        delete node;
+}
+
+void Json::retain() const noexcept{
+    m_node->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Json::release() noexcept{
+    if (m_node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    Arena *arena = m_node->arena;
+    switch (m_kind){
+        case Kind::K_STRING: destroy_node<StringNode>(m_node); break;
+        case Kind::K_ARRAY:  destroy_node<ArrayNode>(m_node); break;
+        case Kind::K_OBJECT: destroy_node<ObjectNode>(m_node); break;
+        case Kind::K_STRING_VIEW: destroy_node<ViewNode>(m_node); break;
+        case Kind::K_LAZY_ARRAY:
+        case Kind::K_LAZY_OBJECT: destroy_node<LazyNode>(m_node); break;
+        default: break;
     }
-    //std::map's operator [] is not declared as const, and cannot be due to its behavior
-    //in C++11, you can use the at() operator
-    const Json& operator[](const string &key) const{
-        return m_value.at(key);
+    //the last node of a document-owned arena takes the arena with it
+    if (arena && arena->m_nodes.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        std::shared_ptr<Arena> self = std::move(arena->m_self);
     }
+}
 
-    JsonObject(const Json::object &value): Value(value){}
-    JsonObject(Json::object &&value) : Value(value){}
-};
-
-class JsonNull final : public Value<Json::JsonType::T_NULL, std::nullptr_t> {
-public:
-    JsonNull() : Value(nullptr) {}
-};
+static inline const StringNode *as_string(const JsonNode *node) {return static_cast<const StringNode *>(node);}
+static inline const ArrayNode *as_array(const JsonNode *node)   {return static_cast<const ArrayNode *>(node);}
+static inline const ObjectNode *as_object(const JsonNode *node) {return static_cast<const ObjectNode *>(node);}
+static inline const ViewNode *as_view(const JsonNode *node)     {return static_cast<const ViewNode *>(node);}
+static inline const LazyNode *as_lazy(const JsonNode *node)     {return static_cast<const LazyNode *>(node);}
 
 //Json constructor
-static const std::shared_ptr<JsonValue> obj_null(std::make_shared<JsonNull>());
-static const std::shared_ptr<JsonValue> obj_true(std::make_shared<JsonBool>(true));
-static const std::shared_ptr<JsonValue> obj_false(std::make_shared<JsonBool>(false));
-
-Json::Json() noexcept               : jv_ptr(obj_null){}
-Json::Json(std::nullptr_t) noexcept : jv_ptr(obj_null){}
-Json::Json(double value)            : jv_ptr(std::make_shared<JsonDouble>(value)){}
-Json::Json(int value)               : jv_ptr(std::make_shared<JsonInt>(value)){} 
-Json::Json(bool value)              : jv_ptr(value ? obj_true : obj_false){}
-Json::Json(const std::string& value): jv_ptr(std::make_shared<JsonString>(value)){}
-Json::Json(std::string&& value)     : jv_ptr(std::make_shared<JsonString>(std::move(value))) {}
-Json::Json(const char* value)       : jv_ptr(std::make_shared<JsonString>(value)){}
-Json::Json(const array& value)      : jv_ptr(std::make_shared<JsonArray>(value)){}
-Json::Json(array&& value)           : jv_ptr(std::make_shared<JsonArray>(std::move(value))){}
-Json::Json(const object & value)    : jv_ptr(std::make_shared<JsonObject>(value)){}
-Json::Json(object && value)         : jv_ptr(std::make_shared<JsonObject>(std::move(value))){}
-
-
-Json::Json(const Json& rhs){
-    switch(rhs.type()){
-        case JsonType::T_NULL:
-            jv_ptr = obj_null;
-            break;
-        case JsonType::T_NUMBER:
-            jv_ptr = std::make_shared<JsonDouble>(rhs.double_value());
-            break;
-        case JsonType::T_BOOL:
-            jv_ptr = (rhs.bool_value()? obj_true : obj_false);
-            break;
-        case JsonType::T_STRING:
-            jv_ptr = std::make_shared<JsonString>(rhs.string_value());
-            break;
-        case JsonType::T_ARRAY:
-            jv_ptr = std::make_shared<JsonArray>(rhs.array_value());
-            break;
-        case JsonType::T_OBJECT:
-            jv_ptr = std::make_shared<JsonObject>(rhs.object_value());
-            break;        
+Json::Json(const std::string& value): Json(make_node<StringNode>(Kind::K_STRING, nullptr, value)){}
+Json::Json(std::string&& value)     : Json(make_node<StringNode>(Kind::K_STRING, nullptr, std::move(value))){}
+Json::Json(const char* value)       : Json(make_node<StringNode>(Kind::K_STRING, nullptr, value)){}
+Json::Json(const array& value)      : Json(make_node<ArrayNode>(Kind::K_ARRAY, nullptr, value)){}
+Json::Json(array&& value)           : Json(make_node<ArrayNode>(Kind::K_ARRAY, nullptr, std::move(value))){}
+Json::Json(const object & value)    : Json(make_node<ObjectNode>(Kind::K_OBJECT, nullptr, value)){}
+Json::Json(object && value)         : Json(make_node<ObjectNode>(Kind::K_OBJECT, nullptr, std::move(value))){}
+
+//copy-on-write: every mutation must go through here, so that the other owners keep seeing the old value.
+//The shallow copy of a container only shares its children, so cloning stays one level deep.
+//A lazy container is always replaced by a built one, even when it is not shared.
+JsonNode *Json::detach(){
+    bool lazy = m_kind == Kind::K_LAZY_ARRAY || m_kind == Kind::K_LAZY_OBJECT;
+    if (!is_node() || (!lazy && m_node->refs.load(std::memory_order_acquire) == 1))
+        return is_node() ? m_node : nullptr;
+    switch (m_kind){
+        case Kind::K_STRING: *this = make_node<StringNode>(m_kind, nullptr, as_string(m_node)->m_value); break;
+        case Kind::K_STRING_VIEW: *this = make_node<StringNode>(Kind::K_STRING, nullptr, as_view(m_node)->str()); break;
+        case Kind::K_ARRAY:
+        case Kind::K_LAZY_ARRAY: *this = make_node<ArrayNode>(Kind::K_ARRAY, nullptr, array_value()); break;
+        default:             *this = make_node<ObjectNode>(Kind::K_OBJECT, nullptr, object_value()); break;
     }
+    return m_node;
 }
 
-Json::Json(Json&& rhs) noexcept : jv_ptr(std::move(rhs.jv_ptr)) {}
-Json::~Json() {}
+//comparison
+//integers are compared exactly, going through double would merge neighbours above 2^53
+template<typename T>
+static inline int compare_values(T lhs, T rhs){
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
 
-Json& Json::operator=(Json rhs){
-    using std::swap;
-    swap(jv_ptr, rhs.jv_ptr);
+//exact integer/double comparison: compare the integral parts as integers, then the fraction
+template<typename Int>
+static int compare_integer_double(Int lhs, double rhs){
+    const double lower = static_cast<double>(std::numeric_limits<Int>::min());
+    const double upper = std::ldexp(1.0, std::numeric_limits<Int>::digits); //2^63 or 2^64, exact
+    if (rhs != rhs) return -1; //NaN, never built by the parser
+    if (rhs < lower) return 1;
+    if (rhs >= upper) return -1;
+    double integral = std::trunc(rhs);
+    int c = compare_values(lhs, static_cast<Int>(integral));
+    if (c) return c;
+    return compare_values(0.0, rhs - integral);
+}
+
+//byte-wise, like std::string::compare, whether the characters are owned or viewed
+static int compare_strings(StringView lhs, StringView rhs){
+    int r = memcmp(lhs.data, rhs.data, std::min(lhs.size, rhs.size));
+    return r ? r : compare_values(lhs.size, rhs.size);
+}
+
+int Json::compare_numbers(const Json &lhs, const Json &rhs){
+    if (lhs.m_kind == Kind::K_DOUBLE && rhs.m_kind == Kind::K_DOUBLE)
+        return compare_values(lhs.m_double, rhs.m_double);
+    if (lhs.m_kind == Kind::K_DOUBLE)
+        return -compare_numbers(rhs, lhs);
+    if (rhs.m_kind == Kind::K_DOUBLE)
+        return lhs.m_kind == Kind::K_INT ? compare_integer_double(lhs.m_int, rhs.m_double)
+                                         : compare_integer_double(lhs.m_uint, rhs.m_double);
+    if (lhs.m_kind != rhs.m_kind)
+        return lhs.m_kind == Kind::K_UINT ? 1 : -1; //every K_UINT is above INT64_MAX
+    return lhs.m_kind == Kind::K_INT ? compare_values(lhs.m_int, rhs.m_int) : compare_values(lhs.m_uint, rhs.m_uint);
 }
 
-//comparison
 bool Json::operator==(const Json& rhs) const{
-    if (jv_ptr->type() != rhs.type())
+    if (type() != rhs.type())
         return false;
-    return jv_ptr->equals(rhs.jv_ptr.get());
+    switch (m_kind){
+        case Kind::K_NULL:   return true;
+        case Kind::K_BOOL:   return m_bool == rhs.m_bool;
+        case Kind::K_INT:
+        case Kind::K_UINT:
+        case Kind::K_DOUBLE: return compare_numbers(*this, rhs) == 0;
+        default:
+            if (m_node == rhs.m_node) return true;
+            if (is_string()) return compare_strings(string_view(), rhs.string_view()) == 0;
+            if (is_array()) return array_value() == rhs.array_value();
+            return object_value() == rhs.object_value();
+    }
 }
 
 bool Json::operator>(const Json& rhs) const{
-    if (jv_ptr->type() != rhs.type())
+    if (type() != rhs.type())
         return false;
-    return rhs.jv_ptr->less(jv_ptr.get());
+    switch (m_kind){
+        case Kind::K_NULL:   return false;
+        case Kind::K_BOOL:   return rhs.m_bool < m_bool;
+        case Kind::K_INT:
+        case Kind::K_UINT:
+        case Kind::K_DOUBLE: return compare_numbers(*this, rhs) > 0;
+        case Kind::K_STRING:
+        case Kind::K_STRING_VIEW: return compare_strings(string_view(), rhs.string_view()) > 0;
+        case Kind::K_ARRAY:
+        case Kind::K_LAZY_ARRAY: return rhs.array_value() < array_value();
+        default:             return rhs.object_value() < object_value();
+    }
 }
 
-//check type
-Json::JsonType Json::type()   const {return jv_ptr->type();}
-bool Json::is_null()    const {return type()==JsonType::T_NULL;}
-bool Json::is_number()  const {return type()==JsonType::T_NUMBER;}
-bool Json::is_bool()    const {return type()==JsonType::T_BOOL;}
-bool Json::is_string()  const {return type()==JsonType::T_STRING;}
-bool Json::is_array()   const {return type()==JsonType::T_ARRAY;}
-bool Json::is_object()  const {return type()==JsonType::T_OBJECT;}
-
 //get value
-int Json::int_value()                       const {return jv_ptr->int_value();}
-double Json::double_value()                 const {return jv_ptr->double_value();}
-const string &Json::string_value()          const {return jv_ptr->string_value();}
-bool Json::bool_value()                     const {return jv_ptr->bool_value();}
-const Json::array &Json::array_value()      const {return jv_ptr->array_value();}
-const Json::object &Json::object_value()    const {return jv_ptr->object_value();}
+int Json::int_value() const{
+    return static_cast<int>(int64_value());//cast
+}
+int64_t Json::int64_value() const{
+    if (m_kind == Kind::K_INT) return m_int;
+    if (m_kind == Kind::K_UINT) return static_cast<int64_t>(m_uint);
+    if (m_kind == Kind::K_DOUBLE) return static_cast<int64_t>(m_double);
+    throw std::runtime_error("not a number!");
+}
+uint64_t Json::uint64_value() const{
+    if (m_kind == Kind::K_INT) return static_cast<uint64_t>(m_int);
+    if (m_kind == Kind::K_UINT) return m_uint;
+    if (m_kind == Kind::K_DOUBLE) return static_cast<uint64_t>(m_double);
+    throw std::runtime_error("not a number!");
+}
+double Json::double_value() const{
+    if (m_kind == Kind::K_DOUBLE) return m_double;
+    if (m_kind == Kind::K_INT) return static_cast<double>(m_int);
+    if (m_kind == Kind::K_UINT) return static_cast<double>(m_uint);
+    throw std::runtime_error("not a number!");
+}
+bool Json::bool_value() const{
+    if (m_kind != Kind::K_BOOL) throw std::runtime_error("not a boolean!");
+    return m_bool;
+}
+const string &Json::string_value() const{
+    if (m_kind == Kind::K_STRING_VIEW) return as_view(m_node)->str();
+    if (m_kind != Kind::K_STRING) throw std::runtime_error("not a string!");
+    return as_string(m_node)->m_value;
+}
+StringView Json::string_view() const{
+    if (m_kind == Kind::K_STRING_VIEW) return StringView{as_view(m_node)->m_data, as_view(m_node)->m_size};
+    if (m_kind != Kind::K_STRING) throw std::runtime_error("not a string!");
+    const string &value = as_string(m_node)->m_value;
+    return StringView{value.data(), value.size()};
+}
+const Json::array &Json::array_value() const{
+    if (m_kind == Kind::K_LAZY_ARRAY) return as_lazy(m_node)->value().array_value();
+    if (m_kind != Kind::K_ARRAY) throw std::runtime_error("not a array!");
+    return as_array(m_node)->m_value;
+}
+const Json::object &Json::object_value() const{
+    if (m_kind == Kind::K_LAZY_OBJECT) return as_lazy(m_node)->value().object_value();
+    if (m_kind != Kind::K_OBJECT) throw std::runtime_error("not a object!");
+    return as_object(m_node)->m_value;
+}
 
 const Json& Json::operator[](size_t i) const{
-    return jv_ptr->operator[](i);
+    if (!is_array()) throw std::runtime_error("not an array");
+    const array &values = array_value();
+    if (i >= values.size()) return json_null;
+    return values[i];
+}
+//std::map's operator [] is not declared as const, and cannot be due to its behavior
+//in C++11, you can use the at() operator
+const Json& Json::operator[](const std::string &key) const{
+    if (!is_object()) throw std::runtime_error("not an object");
+    return object_value().at(key);
+}
+const Json& Json::find_key(const JsonKey &key) const{
+    if (!is_object()) throw std::runtime_error("not an object");
+#ifdef LXJSON_FLAT_OBJECT
+    return object_value().at(key);
+#else
+    return object_value().at(key.str());
+#endif
+}
+
+//Edits: every one goes through detach(), the containers above were detached by the edit() that
+//led here
+Json::array &Json::edit_array(){
+    if (is_null()) *this = Json(array());
+    else if (!is_array()) throw std::runtime_error("not an array");
+    return static_cast<ArrayNode *>(detach())->m_value;
+}
 
+Json::object &Json::edit_object(){
+    if (is_null()) *this = Json(object());
+    else if (!is_object()) throw std::runtime_error("not an object");
+    return static_cast<ObjectNode *>(detach())->m_value;
 }
-const Json& Json::operator[](const std::string key) const{
-    return jv_ptr->operator[](key);
+
+Json& Json::edit(size_t i){
+    if (!is_array()) throw std::runtime_error("not an array");
+    if (i >= array_value().size()) throw std::out_of_range("Json::edit");
+    return edit_array()[i];
 }
 
-void Json::serialize(std::string &out) const{
-    jv_ptr->serialize(out);
+//found before inserting, so that an existing key costs no conversion to the key type
+Json& Json::edit(const std::string &key){
+    object &members = edit_object();
+    object::iterator it = members.find(key);
+    return it != members.end() ? it->second : members.emplace(key, Json()).first->second;
 }
 
+Json& Json::edit_key(const JsonKey &key){
+#ifdef LXJSON_FLAT_OBJECT
+    object &members = edit_object();
+    object::iterator it = members.find(key);
+    return it != members.end() ? it->second : members.emplace(key, Json()).first->second;
+#else
+    return edit(key.str());
+#endif
+}
 
-//todo:
-class jParser final {
-public:
-    jParser(const string& s) : start_(s.c_str()), pos_(s.c_str()){}
-    Json parse(){
-        switch(*start_){
-            case 'n':
-                return parseLiteral("null", Json(nullptr));
-            case 't':
-                return parseLiteral("true", Json(true));
-            case 'f':
-                return parseLiteral("false", Json(false));
-                //break;
-            case '\"':
-                return parseString();
-            case '[':
-                return parseArray();
-            case '{':
-                return parseObject();
-            case '\0':
-                std::runtime_error("Unexpected end");
-            default:
-                //todo
-                return parseNum();
-                //return json_null;
-        }
+void Json::push_back(Json value){
+    edit_array().push_back(std::move(value));
+}
+
+//a missing key leaves a shared object shared
+bool Json::erase(const std::string &key){
+    if (!is_object()) throw std::runtime_error("not an object");
+    if (!object_value().count(key)) return false;
+    edit_object().erase(key);
+    return true;
+}
+
+void Json::erase(size_t i){
+    if (!is_array()) throw std::runtime_error("not an array");
+    if (i >= array_value().size()) throw std::out_of_range("Json::erase");
+    array &values = edit_array();
+    values.erase(values.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+template<typename Style>
+void Json::write(JsonWriter &out, unsigned depth) const{
+    switch (m_kind){
+        case Kind::K_NULL:   lxjson::serialize(nullptr, out); break;
+        case Kind::K_BOOL:   lxjson::serialize(m_bool, out); break;
+        case Kind::K_INT:    lxjson::serialize(m_int, out); break;
+        case Kind::K_UINT:   lxjson::serialize(m_uint, out); break;
+        case Kind::K_DOUBLE: lxjson::serialize(m_double, out); break;
+        case Kind::K_STRING: lxjson::serialize(as_string(m_node)->m_value, out); break;
+        case Kind::K_STRING_VIEW: lxjson::serialize(string_view(), out); break;
+        case Kind::K_ARRAY:  lxjson::serialize<Style>(as_array(m_node)->m_value, out, depth); break;
+        case Kind::K_OBJECT: lxjson::serialize<Style>(as_object(m_node)->m_value, out, depth); break;
+        case Kind::K_LAZY_ARRAY:
+        case Kind::K_LAZY_OBJECT: as_lazy(m_node)->value().write<Style>(out, depth); break;
     }
-    void skipSpace(){
-        while (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r' || *pos_ == '\n')
-            pos_++;
-        start_ = pos_;
+}
+
+void JsonWriter::write_document(const Json &value){
+    switch (m_options.style){
+        case SerializeOptions::Style::DEFAULT: write<DefaultStyle>(value, *this, 0); break;
+        case SerializeOptions::Style::COMPACT: write<CompactStyle>(value, *this, 0); break;
+        case SerializeOptions::Style::PRETTY:  write<PrettyStyle>(value, *this, 0); break;
     }
+}
 
-    char get_pos(){
-        return *pos_;
+void Json::serialize(std::string &out, const SerializeOptions &options) const{
+    //sized for the longest form of the doubles (formatting them twice would cost more than the
+    //extra room), plus some slack for the room reserve() asks for
+    size_t at = out.size(), bound = JsonWriter::document_size<false>(*this, options) + 32;
+    out.resize(at + bound);
+    JsonWriter writer(&out[0] + at, &out[0] + at + bound, options);
+    try {
+        writer.write_document(*this);
+    } catch (...) {
+        out.resize(at); //an invalid string, out is given back as it was
+        throw;
     }
-private:
-    const char* start_;
-    const char* pos_;
+    out.resize(writer.position() - out.data());
+}
 
-    Json parseLiteral(const string &expected, Json res){
-        if (strncmp(pos_, expected.c_str(), expected.size()))
-            throw std::runtime_error(("Expected string ") + expected + (" but failed!"));
-        pos_ += expected.size();
-        return res;
+bool Json::serialize(JsonSink &sink, const SerializeOptions &options) const{
+    JsonWriter writer(sink, options);
+    writer.write_document(*this);
+    return writer.finish();
+}
+
+template<bool Exact, typename Style>
+size_t JsonWriter::size(const Json &value, const SerializeOptions &options, unsigned depth){
+    using Kind = Json::Kind;
+    switch (value.m_kind){
+        case Kind::K_NULL:   return 4;
+        case Kind::K_BOOL:   return value.m_bool ? 4 : 5;
+        case Kind::K_INT: {
+            int64_t v = value.m_int;
+            return (v < 0) + decimal_length(v < 0 ? 0 - static_cast<uint64_t>(v) : static_cast<uint64_t>(v));
+        }
+        case Kind::K_UINT:   return decimal_length(value.m_uint);
+        case Kind::K_DOUBLE: {
+            if (!Exact) return 25;
+            char buf[32];
+            return static_cast<size_t>(write_double(value.m_double, buf) - buf);
+        }
+        case Kind::K_STRING:
+        case Kind::K_STRING_VIEW: return serialized_size(value.string_view(), options);
+        case Kind::K_ARRAY:
+        case Kind::K_LAZY_ARRAY: {
+            const Json::array &values = value.array_value();
+            size_t total = Style::container_size(values.size(), depth, options.indent);
+            for (auto &item : values) total += size<Exact, Style>(item, options, depth + 1);
+            return total;
+        }
+        default: {
+            const Json::object &values = value.object_value();
+            size_t total = Style::container_size(values.size(), depth, options.indent);
+            for (auto &item : values){
+                const string &key = item.first;
+                total += serialized_size(StringView{key.data(), key.size()}, options) + Style::colon_size
+                         + size<Exact, Style>(item.second, options, depth + 1);
+            }
+            return total;
+        }
     }
+}
 
-    string parse4hex() {
-        string res;
-        uint16_t ch16;
-        size_t convSize;
-        do{
-            if (strncmp(pos_, "\\u", 2))
-                throw std::runtime_error("Expected `\\uXXXX` escape sequence at position " + std::to_string(pos_-start_));
-            pos_ += 2;
-            if (sscanf(pos_, "%04hx", &ch16) != 1)
-                throw std::runtime_error("Expected 4 hexadecimal digit sequence at position " + std::to_string((pos_ - start_)));
-            convSize = utf16_to_utf8(ch16, res);
-            if (convSize == static_cast<size_t>(-1))
-                throw std::runtime_error("Bad utf-16 code point at position " + std::to_string(pos_ - start_));
-            pos_ += 4;
-        }while (!convSize);
-        return res;
+template<bool Exact>
+size_t JsonWriter::document_size(const Json &value, const SerializeOptions &options){
+    switch (options.style){
+        case SerializeOptions::Style::COMPACT: return size<Exact, CompactStyle>(value, options, 0);
+        case SerializeOptions::Style::PRETTY:  return size<Exact, PrettyStyle>(value, options, 0);
+        default:                               return size<Exact, DefaultStyle>(value, options, 0);
     }
+}
 
-    //reference: https://github.com/MichaelSuen-thePointer/SimpleJSON/blob/master/SimpleJSON/jparser.cpp
-    size_t utf16_to_utf8(char16_t c16, std::string& s)
-    {
-        int nextra;
+size_t Json::serialized_size(const SerializeOptions &options) const{
+    return JsonWriter::document_size<true>(*this, options);
+}
 
-        static struct internal_state_t
-        {
-            unsigned long _wchar;
-            unsigned short _byte, _state;
-        } pst{};
 
-        char state = static_cast<char>(pst._state); /* number of extra words expected */
-        unsigned long wc = pst._wchar; /* cumulative character */
+//Numbers
+//Decimal to double without strtod: Clinger's fast path when the mantissa and the power of ten are
+//both exact doubles, then the Eisel-Lemire algorithm (as in fast_float) with a 128-bit truncated
+//power of five, and a locale-independent strtod for the few inputs neither of them can settle.
+static const int smallest_power_of_five = -342;
+static const int largest_power_of_five = 308;
 
-        if (state != 0)
-        { /* fold in second word and convert */
-            if (c16 < 0xdc00 || 0xe000 <= c16)
-            {
-                pst = {};
-                return static_cast<size_t>(-1); /* invalid second word */
-            }
-            pst._state = 0;
-            wc |= static_cast<unsigned long>(c16 - 0xdc00);
-        }
-        else if (c16 < 0xd800 || 0xdc00 <= c16)
-        {
-            wc = static_cast<unsigned long>(c16); /* not first word */
-        }
-        else
-        { /* save value bits of first word for later */
-            pst._state = 1;
-            pst._wchar = static_cast<unsigned long>((c16 - 0xd800 + 0x0040) << 10);
-            return (0);
-        }
+//5^q for q in [-342, 308], normalized and truncated to 128 bits (high word first)
+static const uint64_t power_of_five_128[][2] = {
+    {0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL},
+    {0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL},
+    {0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL},
+    {0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL},
+    {0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL},
+    {0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL},
+    {0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL},
+    {0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL},
+    {0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL},
+    {0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL},
+    {0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL},
+    {0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL},
+    {0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL},
+    {0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL},
+    {0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL},
+    {0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL},
+    {0x84a57695fe98746dULL, 0x014bb630f7604b57ULL},
+    {0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL},
+    {0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL},
+    {0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL},
+    {0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL},
+    {0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL},
+    {0xfd00b897478238d0ULL, 0x8920b098955522b4ULL},
+    {0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL},
+    {0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL},
+    {0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL},
+    {0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL},
+    {0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL},
+    {0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL},
+    {0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL},
+    {0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL},
+    {0xeba09271e88d976bULL, 0xf7864a44c633682eULL},
+    {0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL},
+    {0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL},
+    {0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL},
+    {0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL},
+    {0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL},
+    {0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL},
+    {0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL},
+    {0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL},
+    {0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL},
+    {0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL},
+    {0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL},
+    {0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL},
+    {0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL},
+    {0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL},
+    {0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL},
+    {0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL},
+    {0xa37fce126597973cULL, 0xe50ff107bab528a0ULL},
+    {0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL},
+    {0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL},
+    {0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL},
+    {0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL},
+    {0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL},
+    {0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL},
+    {0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL},
+    {0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL},
+    {0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL},
+    {0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL},
+    {0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL},
+    {0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL},
+    {0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL},
+    {0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL},
+    {0x91376c36d99995beULL, 0x23100809b9c21fa1ULL},
+    {0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL},
+    {0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL},
+    {0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL},
+    {0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL},
+    {0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL},
+    {0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL},
+    {0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL},
+    {0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL},
+    {0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL},
+    {0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL},
+    {0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL},
+    {0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL},
+    {0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL},
+    {0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL},
+    {0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL},
+    {0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL},
+    {0xc987434744ac874eULL, 0xa327ffb266b56220ULL},
+    {0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL},
+    {0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL},
+    {0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL},
+    {0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL},
+    {0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL},
+    {0xc0314325637a1939ULL, 0xfa911155fefb5308ULL},
+    {0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL},
+    {0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL},
+    {0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL},
+    {0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL},
+    {0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL},
+    {0xb749faed14125d36ULL, 0xcef980ec671f667bULL},
+    {0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL},
+    {0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL},
+    {0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL},
+    {0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL},
+    {0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL},
+    {0xaecc49914078536dULL, 0x58fae9f773886e18ULL},
+    {0xda7f5bf590966848ULL, 0xaf39a475506a899eULL},
+    {0x888f99797a5e012dULL, 0x6d8406c952429603ULL},
+    {0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL},
+    {0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL},
+    {0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL},
+    {0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL},
+    {0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL},
+    {0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL},
+    {0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL},
+    {0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL},
+    {0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL},
+    {0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL},
+    {0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL},
+    {0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL},
+    {0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL},
+    {0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL},
+    {0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL},
+    {0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL},
+    {0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL},
+    {0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL},
+    {0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL},
+    {0xb913179899f68584ULL, 0x28e2557b59846e3fULL},
+    {0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL},
+    {0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL},
+    {0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL},
+    {0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL},
+    {0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL},
+    {0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL},
+    {0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL},
+    {0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL},
+    {0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL},
+    {0xd77485cb25823ac7ULL, 0x7d633293366b828bULL},
+    {0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL},
+    {0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL},
+    {0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL},
+    {0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL},
+    {0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL},
+    {0xcd795be870516656ULL, 0x67902e276c921f8bULL},
+    {0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL},
+    {0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL},
+    {0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL},
+    {0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL},
+    {0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL},
+    {0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL},
+    {0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL},
+    {0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL},
+    {0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL},
+    {0xef340a98172aace4ULL, 0x86fb897116c87c34ULL},
+    {0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL},
+    {0xbae0a846d2195712ULL, 0x8974836059cca109ULL},
+    {0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL},
+    {0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL},
+    {0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL},
+    {0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL},
+    {0x8e938662882af53eULL, 0x547eb47b7282ee9cULL},
+    {0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL},
+    {0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL},
+    {0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL},
+    {0xae0b158b4738705eULL, 0x9624ab50b148d445ULL},
+    {0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL},
+    {0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL},
+    {0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL},
+    {0xd47487cc8470652bULL, 0x7647c3200069671fULL},
+    {0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL},
+    {0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL},
+    {0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL},
+    {0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL},
+    {0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL},
+    {0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL},
+    {0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL},
+    {0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL},
+    {0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL},
+    {0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL},
+    {0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL},
+    {0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL},
+    {0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL},
+    {0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL},
+    {0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL},
+    {0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL},
+    {0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL},
+    {0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL},
+    {0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL},
+    {0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL},
+    {0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL},
+    {0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL},
+    {0x8c974f7383725573ULL, 0x1e414218c73a13fbULL},
+    {0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL},
+    {0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL},
+    {0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL},
+    {0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL},
+    {0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL},
+    {0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL},
+    {0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL},
+    {0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL},
+    {0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL},
+    {0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL},
+    {0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL},
+    {0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL},
+    {0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL},
+    {0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL},
+    {0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL},
+    {0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL},
+    {0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL},
+    {0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL},
+    {0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL},
+    {0xbe89523386091465ULL, 0xf6bbb397f1135823ULL},
+    {0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL},
+    {0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL},
+    {0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL},
+    {0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL},
+    {0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL},
+    {0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL},
+    {0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL},
+    {0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL},
+    {0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL},
+    {0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL},
+    {0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL},
+    {0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL},
+    {0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL},
+    {0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL},
+    {0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL},
+    {0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL},
+    {0x843610cb4bf160cbULL, 0xcedf722a585139baULL},
+    {0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL},
+    {0xce947a3da6a9273eULL, 0x733d226229feea32ULL},
+    {0x811ccc668829b887ULL, 0x0806357d5a3f525fULL},
+    {0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL},
+    {0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL},
+    {0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL},
+    {0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL},
+    {0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL},
+    {0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL},
+    {0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL},
+    {0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL},
+    {0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL},
+    {0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL},
+    {0xbbe226efb628afeaULL, 0x890489f70a55368bULL},
+    {0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL},
+    {0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL},
+    {0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL},
+    {0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL},
+    {0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL},
+    {0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL},
+    {0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL},
+    {0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL},
+    {0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL},
+    {0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL},
+    {0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL},
+    {0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL},
+    {0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL},
+    {0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL},
+    {0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL},
+    {0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL},
+    {0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL},
+    {0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL},
+    {0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL},
+    {0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL},
+    {0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL},
+    {0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL},
+    {0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL},
+    {0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL},
+    {0xc24452da229b021bULL, 0xfbe85badce996168ULL},
+    {0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL},
+    {0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL},
+    {0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL},
+    {0xed246723473e3813ULL, 0x290123e9aab23b68ULL},
+    {0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL},
+    {0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL},
+    {0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL},
+    {0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL},
+    {0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL},
+    {0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL},
+    {0x8d590723948a535fULL, 0x579c487e5a38ad0eULL},
+    {0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL},
+    {0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL},
+    {0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL},
+    {0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL},
+    {0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL},
+    {0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL},
+    {0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL},
+    {0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL},
+    {0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL},
+    {0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL},
+    {0xcdb02555653131b6ULL, 0x3792f412cb06794dULL},
+    {0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL},
+    {0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL},
+    {0xc8de047564d20a8bULL, 0xf245825a5a445275ULL},
+    {0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL},
+    {0x9ced737bb6c4183dULL, 0x55464dd69685606bULL},
+    {0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL},
+    {0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL},
+    {0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL},
+    {0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL},
+    {0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL},
+    {0x95a8637627989aadULL, 0xdde7001379a44aa8ULL},
+    {0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL},
+    {0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL},
+    {0x9226712162ab070dULL, 0xcab3961304ca70e8ULL},
+    {0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL},
+    {0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL},
+    {0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL},
+    {0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL},
+    {0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL},
+    {0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL},
+    {0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL},
+    {0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL},
+    {0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL},
+    {0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL},
+    {0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL},
+    {0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL},
+    {0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL},
+    {0xcfb11ead453994baULL, 0x67de18eda5814af2ULL},
+    {0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL},
+    {0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL},
+    {0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL},
+    {0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL},
+    {0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL},
+    {0xc612062576589ddaULL, 0x95364afe032a819eULL},
+    {0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL},
+    {0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL},
+    {0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL},
+    {0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL},
+    {0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL},
+    {0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL},
+    {0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL},
+    {0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL},
+    {0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL},
+    {0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL},
+    {0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL},
+    {0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL},
+    {0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL},
+    {0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL},
+    {0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL},
+    {0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL},
+    {0x89705f4136b4a597ULL, 0x31680a88f8953031ULL},
+    {0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL},
+    {0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL},
+    {0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL},
+    {0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL},
+    {0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL},
+    {0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL},
+    {0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL},
+    {0xccccccccccccccccULL, 0xcccccccccccccccdULL},
+    {0x8000000000000000ULL, 0x0000000000000000ULL},
+    {0xa000000000000000ULL, 0x0000000000000000ULL},
+    {0xc800000000000000ULL, 0x0000000000000000ULL},
+    {0xfa00000000000000ULL, 0x0000000000000000ULL},
+    {0x9c40000000000000ULL, 0x0000000000000000ULL},
+    {0xc350000000000000ULL, 0x0000000000000000ULL},
+    {0xf424000000000000ULL, 0x0000000000000000ULL},
+    {0x9896800000000000ULL, 0x0000000000000000ULL},
+    {0xbebc200000000000ULL, 0x0000000000000000ULL},
+    {0xee6b280000000000ULL, 0x0000000000000000ULL},
+    {0x9502f90000000000ULL, 0x0000000000000000ULL},
+    {0xba43b74000000000ULL, 0x0000000000000000ULL},
+    {0xe8d4a51000000000ULL, 0x0000000000000000ULL},
+    {0x9184e72a00000000ULL, 0x0000000000000000ULL},
+    {0xb5e620f480000000ULL, 0x0000000000000000ULL},
+    {0xe35fa931a0000000ULL, 0x0000000000000000ULL},
+    {0x8e1bc9bf04000000ULL, 0x0000000000000000ULL},
+    {0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL},
+    {0xde0b6b3a76400000ULL, 0x0000000000000000ULL},
+    {0x8ac7230489e80000ULL, 0x0000000000000000ULL},
+    {0xad78ebc5ac620000ULL, 0x0000000000000000ULL},
+    {0xd8d726b7177a8000ULL, 0x0000000000000000ULL},
+    {0x878678326eac9000ULL, 0x0000000000000000ULL},
+    {0xa968163f0a57b400ULL, 0x0000000000000000ULL},
+    {0xd3c21bcecceda100ULL, 0x0000000000000000ULL},
+    {0x84595161401484a0ULL, 0x0000000000000000ULL},
+    {0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL},
+    {0xcecb8f27f4200f3aULL, 0x0000000000000000ULL},
+    {0x813f3978f8940984ULL, 0x4000000000000000ULL},
+    {0xa18f07d736b90be5ULL, 0x5000000000000000ULL},
+    {0xc9f2c9cd04674edeULL, 0xa400000000000000ULL},
+    {0xfc6f7c4045812296ULL, 0x4d00000000000000ULL},
+    {0x9dc5ada82b70b59dULL, 0xf020000000000000ULL},
+    {0xc5371912364ce305ULL, 0x6c28000000000000ULL},
+    {0xf684df56c3e01bc6ULL, 0xc732000000000000ULL},
+    {0x9a130b963a6c115cULL, 0x3c7f400000000000ULL},
+    {0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL},
+    {0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL},
+    {0x96769950b50d88f4ULL, 0x1314448000000000ULL},
+    {0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL},
+    {0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL},
+    {0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL},
+    {0xb7abc627050305adULL, 0xf14a3d9e40000000ULL},
+    {0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL},
+    {0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL},
+    {0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL},
+    {0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL},
+    {0x8c213d9da502de45ULL, 0x4526f422cc340000ULL},
+    {0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL},
+    {0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL},
+    {0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL},
+    {0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL},
+    {0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL},
+    {0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL},
+    {0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL},
+    {0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL},
+    {0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL},
+    {0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL},
+    {0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL},
+    {0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL},
+    {0x9f4f2726179a2245ULL, 0x01d762422c946590ULL},
+    {0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL},
+    {0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL},
+    {0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL},
+    {0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL},
+    {0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL},
+    {0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL},
+    {0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL},
+    {0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL},
+    {0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL},
+    {0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL},
+    {0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL},
+    {0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL},
+    {0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL},
+    {0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL},
+    {0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL},
+    {0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL},
+    {0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL},
+    {0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL},
+    {0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL},
+    {0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL},
+    {0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL},
+    {0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL},
+    {0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL},
+    {0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL},
+    {0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL},
+    {0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL},
+    {0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL},
+    {0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL},
+    {0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL},
+    {0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL},
+    {0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL},
+    {0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL},
+    {0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL},
+    {0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL},
+    {0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL},
+    {0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL},
+    {0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL},
+    {0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL},
+    {0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL},
+    {0x924d692ca61be758ULL, 0x593c2626705f9c56ULL},
+    {0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL},
+    {0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL},
+    {0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL},
+    {0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL},
+    {0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL},
+    {0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL},
+    {0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL},
+    {0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL},
+    {0x884134fe908658b2ULL, 0x3109058d147fdcddULL},
+    {0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL},
+    {0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL},
+    {0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL},
+    {0xa6539930bf6bff45ULL, 0x84db8346b786151cULL},
+    {0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL},
+    {0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL},
+    {0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL},
+    {0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL},
+    {0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL},
+    {0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL},
+    {0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL},
+    {0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL},
+    {0x9ae757596946075fULL, 0x3375788de9b06958ULL},
+    {0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL},
+    {0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL},
+    {0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL},
+    {0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL},
+    {0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL},
+    {0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL},
+    {0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL},
+    {0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL},
+    {0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL},
+    {0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL},
+    {0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL},
+    {0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL},
+    {0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL},
+    {0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL},
+    {0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL},
+    {0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL},
+    {0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL},
+    {0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL},
+    {0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL},
+    {0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL},
+    {0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL},
+    {0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL},
+    {0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL},
+    {0x802221226be55a64ULL, 0xc2494954da2c9789ULL},
+    {0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL},
+    {0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL},
+    {0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL},
+    {0x9c69a97284b578d7ULL, 0xff2a760414536efbULL},
+    {0xc38413cf25e2d70dULL, 0xfef5138519684abaULL},
+    {0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL},
+    {0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL},
+    {0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL},
+    {0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL},
+    {0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL},
+    {0xba756174393d88dfULL, 0x94f971119aeef9e4ULL},
+    {0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL},
+    {0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL},
+    {0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL},
+    {0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL},
+    {0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL},
+    {0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL},
+    {0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL},
+    {0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL},
+    {0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL},
+    {0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL},
+    {0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL},
+    {0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL},
+    {0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL},
+    {0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL},
+    {0xa59bc234db398c25ULL, 0x43fab9837e699095ULL},
+    {0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL},
+    {0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL},
+    {0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL},
+    {0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL},
+    {0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL},
+    {0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL},
+    {0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL},
+    {0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL},
+    {0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL},
+    {0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL},
+    {0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL},
+    {0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL},
+    {0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL},
+    {0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL},
+    {0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL},
+    {0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL},
+    {0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL},
+    {0x8fa475791a569d10ULL, 0xf96e017d694487bcULL},
+    {0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL},
+    {0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL},
+    {0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL},
+    {0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL},
+    {0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL},
+    {0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL},
+    {0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL},
+    {0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL},
+    {0x85c7056562757456ULL, 0xf6872d5667844e49ULL},
+    {0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL},
+    {0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL},
+    {0x82a45b450226b39cULL, 0xecc0024661173473ULL},
+    {0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL},
+    {0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL},
+    {0xff290242c83396ceULL, 0x7e67047175a15271ULL},
+    {0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL},
+    {0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL},
+    {0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL},
+    {0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL},
+    {0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL},
+    {0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL},
+    {0x98165af37b2153deULL, 0xc3727a337a8b704aULL},
+    {0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL},
+    {0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL},
+    {0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL},
+    {0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL},
+    {0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL},
+    {0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL},
+    {0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL},
+    {0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL},
+    {0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL},
+    {0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL},
+    {0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL},
+    {0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL},
+    {0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL},
+    {0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL},
+    {0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL},
+    {0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL},
+    {0xd31045a8341ca07cULL, 0x1ede48111209a050ULL},
+    {0x83ea2b892091e44dULL, 0x934aed0aab460432ULL},
+    {0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL},
+    {0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL},
+    {0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL},
+    {0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL},
+    {0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL},
+    {0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL},
+    {0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL},
+    {0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL},
+    {0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL},
+    {0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL},
+    {0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL},
+    {0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL},
+    {0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL},
+    {0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL},
+    {0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL},
+    {0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL},
+    {0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL},
+    {0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL},
+    {0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL},
+    {0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL},
+    {0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL},
+    {0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL},
+    {0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL},
+    {0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL},
+    {0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL},
+    {0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL},
+    {0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL},
+    {0x8533285c936b35deULL, 0xd53a88958f87275fULL},
+    {0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL},
+    {0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL},
+    {0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL},
+    {0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL},
+    {0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL},
+    {0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL},
+    {0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL},
+    {0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL},
+    {0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL},
+    {0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL},
+    {0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL},
+    {0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL},
+    {0x976e41088617ca01ULL, 0xd5be0503e085d813ULL},
+    {0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL},
+    {0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL},
+    {0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL},
+    {0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL},
+    {0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL},
+    {0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL},
+    {0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL},
+    {0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL},
+    {0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL},
+    {0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL},
+    {0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL},
+    {0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL},
+    {0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL},
+    {0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL},
+    {0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL},
+    {0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL},
+    {0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL},
+    {0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL},
+    {0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL},
+    {0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL},
+    {0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL},
+    {0xa0555e361951c366ULL, 0xd7e105bcc332621fULL},
+    {0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL},
+    {0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL},
+    {0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL},
+    {0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL},
+    {0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL},
+    {0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL},
+    {0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL},
+    {0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL},
+    {0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL},
+    {0xbaa718e68396cffdULL, 0xd30560258f54e6baULL},
+    {0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL},
+    {0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL},
+    {0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL},
+    {0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL},
+    {0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL},
+};
 
-        if ((wc & ~0x7fUL) == 0)
-        { /* generate a single byte */
-            s += static_cast<unsigned char>(wc);
-            nextra = 0;
-        }
-        else if ((wc & ~0x7ffUL) == 0)
-        { /* generate two bytes */
-            s += static_cast<unsigned char>(0xc0 | wc >> 6);
-            nextra = 1;
-        }
-        else if ((wc & ~0xffffUL) == 0)
-        { /* generate three bytes */
-            s += static_cast<unsigned char>(0xe0 | wc >> 12);
-            nextra = 2;
-        }
-        else if ((wc & ~0x1fffffUL) == 0)
-        { /* generate four bytes */
-            s += static_cast<unsigned char>(0xf0 | wc >> 18);
-            nextra = 3;
+static inline void full_multiplication(uint64_t a, uint64_t b, uint64_t &high, uint64_t &low){
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    high = static_cast<uint64_t>(r >> 64);
+    low = static_cast<uint64_t>(r);
+#else
+    uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32, b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + static_cast<uint32_t>(hi_lo) + lo_hi;
+    high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    low = (cross << 32) | static_cast<uint32_t>(lo_lo);
+#endif
+}
+
+//w * 10^q, false when the result could not be decided exactly
+static bool eisel_lemire(uint64_t w, int64_t q, bool negative, double &out){
+    const int mantissa_bits = 52, minimum_exponent = -1023, infinite_power = 0x7FF;
+    uint64_t mantissa;
+    int64_t power2;
+    if (w == 0 || q < smallest_power_of_five){
+        mantissa = 0;
+        power2 = 0;
+    }
+    else if (q > largest_power_of_five){
+        mantissa = 0;
+        power2 = infinite_power;
+    }
+    else {
+        int lz = __builtin_clzll(w);
+        w <<= lz;
+        const uint64_t *power = power_of_five_128[q - smallest_power_of_five];
+        uint64_t high, low;
+        full_multiplication(w, power[0], high, low);
+        const uint64_t precision_mask = ~uint64_t(0) >> (mantissa_bits + 3);
+        if ((high & precision_mask) == precision_mask){
+            uint64_t high2, low2;
+            full_multiplication(w, power[1], high2, low2);
+            low += high2;
+            if (high2 > low) ++high;
         }
-        else if ((wc & ~0x3ffffffUL) == 0)
-        { /* generate five bytes */
-            s += static_cast<unsigned char>(0xf8 | wc >> 24);
-            nextra = 4;
+        if (low == ~uint64_t(0) && (q < -27 || q > 55))
+            return false;
+
+        int upperbit = static_cast<int>(high >> 63);
+        mantissa = high >> (upperbit + 64 - mantissa_bits - 3);
+        power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - minimum_exponent;
+        if (power2 <= 0){
+            //subnormal
+            if (-power2 + 1 >= 64){
+                mantissa = 0;
+                power2 = 0;
+            }
+            else {
+                mantissa >>= -power2 + 1;
+                mantissa += (mantissa & 1);
+                mantissa >>= 1;
+                power2 = mantissa < (uint64_t(1) << mantissa_bits) ? 0 : 1;
+            }
         }
-        else
-        { /* generate six bytes */
-            s += static_cast<unsigned char>(0xfc | ((wc >> 30) & 0x03));
-            nextra = 5;
+        else {
+            //exactly halfway: round to even
+            if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1
+                && (mantissa << (upperbit + 64 - mantissa_bits - 3)) == high)
+                mantissa &= ~uint64_t(1);
+            mantissa += (mantissa & 1);
+            mantissa >>= 1;
+            if (mantissa >= (uint64_t(2) << mantissa_bits)){
+                mantissa = uint64_t(1) << mantissa_bits;
+                ++power2;
+            }
+            mantissa &= ~(uint64_t(1) << mantissa_bits);
+            if (power2 >= infinite_power){
+                mantissa = 0;
+                power2 = infinite_power;
+            }
         }
+    }
+    uint64_t bits = mantissa | static_cast<uint64_t>(power2) << mantissa_bits | static_cast<uint64_t>(negative) << 63;
+    memcpy(&out, &bits, sizeof(out));
+    return true;
+}
 
-        for (int i = nextra; i > 0; --i)
-        {
-            s += static_cast<unsigned char>(0x80 | ((wc >> 6 * (i - 1)) & 0x3f));
-        }
-        return nextra + 1;
+static bool decimal_to_double(uint64_t w, int64_t q, bool negative, double &out){
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    //both operands are exact, so is the correctly rounded product or quotient
+    static const double exact_powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    if (w <= (uint64_t(1) << 53) && q >= -22 && q <= 22){
+        double d = static_cast<double>(w);
+        d = q < 0 ? d / exact_powers_of_ten[-q] : d * exact_powers_of_ten[q];
+        out = negative ? -d : d;
+        return true;
     }
+#endif
+    return eisel_lemire(w, q, negative, out);
+}
 
+//strtod in the "C" locale, whatever the global one is
+static double strtod_c_locale(const char *begin, const char *end){
+    std::istringstream in(string(begin, end));
+    in.imbue(std::locale::classic());
+    double value = 0;
+    in >> value;
+    if (in.fail() && std::fabs(value) == std::numeric_limits<double>::max())
+        return value > 0 ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+    return value;
+}
 
-    void encode_utf8(char c, string& out){
-        switch(c){
-            case '\"' : case '\\': case '/':
-                out.push_back(c);
-                break;
-            case 'b':
-                out.push_back('\b');
-                break;
-            case 't':
-                out.push_back('\t');
-                break;
-            case 'f':
-                out.push_back('\f');
-                break;
-            case 'n':
+//Number formatting
+//Integers are written two digits at a time once their length is known, doubles go through Ryu
+//(Ulf Adams, PLDI 2018): the shortest decimal that parses back to the same bits, correctly rounded
+//when several are as short. Both write into a caller buffer, no locale and no snprintf involved.
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t powers_of_ten[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+//number of decimal digits of v, 1 for 0; setting the low bit never crosses a power of ten
+static inline unsigned decimal_length(uint64_t v){
+    v |= 1;
+    unsigned t = (64 - __builtin_clzll(v)) * 1233 >> 12;
+    return t - (v < powers_of_ten[t]) + 1;
+}
+
+//exactly `length` digits of v at dst
+static inline void write_digits(uint64_t v, unsigned length, char *dst){
+    char *p = dst + length;
+    while (v >= 100){
+        unsigned r = static_cast<unsigned>(v % 100);
+        v /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * r, 2);
+    }
+    if (v >= 10){
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * v, 2);
+    }
+    else
+        *--p = static_cast<char>('0' + v);
+}
+
+//at most 21 characters, returns the end
+static inline char *write_uint64(uint64_t v, bool negative, char *dst){
+    unsigned length = decimal_length(v);
+    if (negative) *dst++ = '-';
+    write_digits(v, length, dst);
+    return dst + length;
+}
+
+//Ryu tables: 5^i and 2^k / 5^i scaled to 125 significant bits, stored as {low word, high word}
+static const int pow5_bitcount = 125;
+static const int pow5_inv_bitcount = 125;
+
+static const uint64_t pow5_inv_split[][2] = {
+    {0x0000000000000001ULL, 0x2000000000000000ULL},
+    {0x999999999999999aULL, 0x1999999999999999ULL},
+    {0x47ae147ae147ae15ULL, 0x147ae147ae147ae1ULL},
+    {0x6c8b4395810624deULL, 0x10624dd2f1a9fbe7ULL},
+    {0x7a786c226809d496ULL, 0x1a36e2eb1c432ca5ULL},
+    {0x61f9f01b866e43abULL, 0x14f8b588e368f084ULL},
+    {0xb4c7f34938583622ULL, 0x10c6f7a0b5ed8d36ULL},
+    {0x87a6520ec08d236aULL, 0x1ad7f29abcaf4857ULL},
+    {0x9fb841a566d74f88ULL, 0x15798ee2308c39dfULL},
+    {0xe62d01511f12a607ULL, 0x112e0be826d694b2ULL},
+    {0xd6ae6881cb5109a4ULL, 0x1b7cdfd9d7bdbab7ULL},
+    {0xdef1ed34a2a73aeaULL, 0x15fd7fe17964955fULL},
+    {0x7f27f0f6e885c8bbULL, 0x119799812dea1119ULL},
+    {0x650cb4be40d60df8ULL, 0x1c25c268497681c2ULL},
+    {0xea70909833de7193ULL, 0x16849b86a12b9b01ULL},
+    {0x21f3a6e0297ec143ULL, 0x1203af9ee756159bULL},
+    {0x6985d7cd0f313537ULL, 0x1cd2b297d889bc2bULL},
+    {0x2137dfd73f5a90f9ULL, 0x170ef54646d49689ULL},
+    {0xe75fe645cc4873faULL, 0x12725dd1d243aba0ULL},
+    {0xa5663d3c7a0d865dULL, 0x1d83c94fb6d2ac34ULL},
+    {0x511e976394d79eb1ULL, 0x179ca10c9242235dULL},
+    {0xda7edf82dd794bc1ULL, 0x12e3b40a0e9b4f7dULL},
+    {0x2a6498d1625bac68ULL, 0x1e392010175ee596ULL},
+    {0xeeb6e0a781e2f053ULL, 0x182db34012b25144ULL},
+    {0x58924d52ce4f26a9ULL, 0x1357c299a88ea76aULL},
+    {0x27507bb7b07ea441ULL, 0x1ef2d0f5da7dd8aaULL},
+    {0x52a6c95fc0655034ULL, 0x18c240c4aecb13bbULL},
+    {0x0eebd44c99eaa690ULL, 0x13ce9a36f23c0fc9ULL},
+    {0xb17953adc3110a80ULL, 0x1fb0f6be50601941ULL},
+    {0xc12ddc8b02740867ULL, 0x195a5efea6b34767ULL},
+    {0x3424b06f3529a052ULL, 0x14484bfeebc29f86ULL},
+    {0x901d59f290ee19dbULL, 0x1039d66589687f9eULL},
+    {0x4cfbc31db4b0295fULL, 0x19f623d5a8a73297ULL},
+    {0x3d9635b15d59bab2ULL, 0x14c4e977ba1f5bacULL},
+    {0x97ab5e277de16228ULL, 0x109d8792fb4c4956ULL},
+    {0xf2abc9d8c9689d0dULL, 0x1a95a5b7f87a0ef0ULL},
+    {0x5bbca17a3aba173eULL, 0x154484932d2e725aULL},
+    {0xafca1ac82efb45cbULL, 0x11039d428a8b8eaeULL},
+    {0xb2dcf7a6b1920945ULL, 0x1b38fb9daa78e44aULL},
+    {0xf57d92ebc141a104ULL, 0x15c72fb1552d836eULL},
+    {0xc46475896767b403ULL, 0x116c262777579c58ULL},
+    {0x6d6d88dbd8a5ecd2ULL, 0x1be03d0bf225c6f4ULL},
+    {0x8abe071646eb23dbULL, 0x164cfda3281e38c3ULL},
+    {0x6efe6c11d255b649ULL, 0x11d7314f534b609cULL},
+    {0xb197134fb6ef8a0eULL, 0x1c8b821885456760ULL},
+    {0x27ac0f72f8bfa1a5ULL, 0x16d601ad376ab91aULL},
+    {0xb95672c260994e1eULL, 0x1244ce242c5560e1ULL},
+    {0xf5571e03cdc21695ULL, 0x1d3ae36d13bbce35ULL},
+    {0x2aac18030b01ababULL, 0x17624f8a762fd82bULL},
+    {0xbbbce0026f348956ULL, 0x12b50c6ec4f31355ULL},
+    {0x92c7ccd0b1eda889ULL, 0x1dee7a4ad4b81eefULL},
+    {0xdbd30a408e57ba07ULL, 0x17f1fb6f10934bf2ULL},
+    {0x7ca8d50071dfc806ULL, 0x1327fc58da0f6ff5ULL},
+    {0xfaa7bb33e9660cd6ULL, 0x1ea6608e29b24cbbULL},
+    {0x9552fc298784d711ULL, 0x18851a0b548ea3c9ULL},
+    {0xaaa8c9bad2d0ac0eULL, 0x139dae6f76d88307ULL},
+    {0xdddadc5e1e1aace3ULL, 0x1f62b0b257c0d1a5ULL},
+    {0x7e48b04b4b488a4fULL, 0x191bc08eac9a4151ULL},
+    {0xcb6d59d5d5d3a1d9ULL, 0x141633a556e1cddaULL},
+    {0x3c577b1177dc817bULL, 0x1011c2eaabe7d7e2ULL},
+    {0xc6f25e825960cf2aULL, 0x19b604aaaca62636ULL},
+    {0x6bf518684780a5bbULL, 0x14919d5556eb51c5ULL},
+    {0x232a79ed06008496ULL, 0x10747ddddf22a7d1ULL},
+    {0xd1dd8fe1a3340756ULL, 0x1a53fc9631d10c81ULL},
+    {0xa7e4731ae8f66c45ULL, 0x150ffd44f4a73d34ULL},
+    {0x531d28e253f8569eULL, 0x10d9976a5d52975dULL},
+    {0xeb61db03b98d5762ULL, 0x1af5bf109550f22eULL},
+    {0xbc4e48cfc7a445e8ULL, 0x159165a6ddda5b58ULL},
+    {0x6371d3d96c836b20ULL, 0x11411e1f17e1e2adULL},
+    {0x9f1c8628ad9f11cdULL, 0x1b9b6364f3030448ULL},
+    {0xe5b06b53be18db0bULL, 0x1615e91d8f359d06ULL},
+    {0xeaf3890fcb4715a2ULL, 0x11ab20e472914a6bULL},
+    {0x44b8db4c7871bc37ULL, 0x1c45016d841baa46ULL},
+    {0x03c715d6c6c1635fULL, 0x169d9abe03495505ULL},
+    {0x3638de456bcde919ULL, 0x1217aefe69077737ULL},
+    {0x56c163a2461641c1ULL, 0x1cf2b1970e725858ULL},
+    {0xdf011c81d1ab67ceULL, 0x17288e1271f51379ULL},
+    {0x7f3416ce4155eca5ULL, 0x1286d80ec190dc61ULL},
+    {0x6520247d3556476eULL, 0x1da48ce468e7c702ULL},
+    {0xea801d30f7783925ULL, 0x17b6d71d20b96c01ULL},
+    {0xbb99b0f3f92cfa84ULL, 0x12f8ac174d612334ULL},
+    {0x5f5c4e532847f739ULL, 0x1e5aacf215683854ULL},
+    {0x7f7d0b75b9d32c2eULL, 0x18488a5b44536043ULL},
+    {0x9930d5f7c7dc2358ULL, 0x136d3b7c36a919cfULL},
+    {0x8eb4898c72f9d226ULL, 0x1f152bf9f10e8fb2ULL},
+    {0x722a07a38f2e41b8ULL, 0x18ddbcc7f40ba628ULL},
+    {0xc1bb394fa5be9afaULL, 0x13e497065cd61e86ULL},
+    {0x9c5ec2190930f7f6ULL, 0x1fd424d6faf030d7ULL},
+    {0x49e56814075a5ff8ULL, 0x197683df2f268d79ULL},
+    {0x6e51201005e1e660ULL, 0x145ecfe5bf520ac7ULL},
+    {0xf1da800cd181851aULL, 0x104bd984990e6f05ULL},
+    {0x4fc400148268d4f5ULL, 0x1a12f5a0f4e3e4d6ULL},
+    {0xd96999aa01ed772bULL, 0x14dbf7b3f71cb711ULL},
+    {0xadee1488018ac5bcULL, 0x10aff95cc5b09274ULL},
+    {0x497ceda668de092cULL, 0x1ab328946f80ea54ULL},
+    {0x3aca57b853e4d424ULL, 0x155c2076bf9a5510ULL},
+    {0x623b7960431d7683ULL, 0x1116805effaeaa73ULL},
+    {0x9d2bf566d1c8bd9eULL, 0x1b5733cb32b110b8ULL},
+    {0x7dbcc452416d647fULL, 0x15df5ca28ef40d60ULL},
+    {0xcafd69db678ab6ccULL, 0x117f7d4ed8c33de6ULL},
+    {0xab2f0fc572778adfULL, 0x1bff2ee48e052fd7ULL},
+    {0x88f273045b92d580ULL, 0x1665bf1d3e6a8cacULL},
+    {0xd3f528d049424466ULL, 0x11eaff4a98553d56ULL},
+    {0xb988414d4203a0a3ULL, 0x1cab3210f3bb9557ULL},
+    {0x6139cdd76802e6e9ULL, 0x16ef5b40c2fc7779ULL},
+    {0xe761717920025254ULL, 0x125915cd68c9f92dULL},
+    {0xa568b58e999d5086ULL, 0x1d5b561574765b7cULL},
+    {0x5120913ee14aa6d2ULL, 0x177c44ddf6c515fdULL},
+    {0xa74d40ff1aa21f0eULL, 0x12c9d0b1923744caULL},
+    {0x0baece64f769cb4aULL, 0x1e0fb44f50586e11ULL},
+    {0x3c8bd850c5ee3c3bULL, 0x180c903f7379f1a7ULL},
+    {0xca0979da37f1c9c9ULL, 0x133d4032c2c7f485ULL},
+    {0xa9a8c2f6bfe942dbULL, 0x1ec866b79e0cba6fULL},
+    {0x2153cf2bccba9be3ULL, 0x18a0522c7e709526ULL},
+    {0x1aa9728970954982ULL, 0x13b374f06526ddb8ULL},
+    {0xf775840f1a88759dULL, 0x1f8587e7083e2f8cULL},
+    {0x5f9136727ba05e17ULL, 0x19379fec0698260aULL},
+    {0x1940f85b9619e4dfULL, 0x142c7ff0054684d5ULL},
+    {0xe100c6afab47ea4cULL, 0x1023998cd1053710ULL},
+    {0xce67a44c453fdd47ULL, 0x19d28f47b4d524e7ULL},
+    {0xd852e9d69dccb106ULL, 0x14a8729fc3ddb71fULL},
+    {0x79dbee454b0a2738ULL, 0x1086c219697e2c19ULL},
+    {0x295fe3a211a9d859ULL, 0x1a71368f0f30468fULL},
+    {0xbab31c81a7bb137aULL, 0x15275ed8d8f36ba5ULL},
+    {0x6228e39aec95a92fULL, 0x10ec4be0ad8f8951ULL},
+    {0x9d0e38f7e0ef7517ULL, 0x1b13ac9aaf4c0ee8ULL},
+    {0xb0d82d931a592a79ULL, 0x15a956e225d67253ULL},
+    {0x8d79be0f4847552eULL, 0x11544581b7dec1dcULL},
+    {0x158f967eda0bbb7cULL, 0x1bba08cf8c979c94ULL},
+    {0x77a611ff14d62f97ULL, 0x162e6d72d6dfb076ULL},
+    {0xf951a7ff43de8c79ULL, 0x11bebdf578b2f391ULL},
+    {0xc21c3ffed2fdad8eULL, 0x1c6463225ab7ec1cULL},
+    {0x01b0333242648ad8ULL, 0x16b6b5b5155ff017ULL},
+    {0x0159c28e9b83a246ULL, 0x122bc490dde659acULL},
+    {0xcef604175f3903a3ULL, 0x1d12d41afca3c2acULL},
+    {0x725e69ac4c2d9c83ULL, 0x17424348ca1c9bbdULL},
+    {0xf5185489d68ae39cULL, 0x129b69070816e2fdULL},
+    {0xee8d540fbdab05c6ULL, 0x1dc574d80cf16b2fULL},
+    {0xbed77672fe226b05ULL, 0x17d12a4670c1228cULL},
+    {0xff12c528cb4ebc04ULL, 0x130dbb6b8d674ed6ULL},
+    {0xcb513b74787df9a0ULL, 0x1e7c5f127bd87e24ULL},
+    {0x090dc929f9fe614dULL, 0x18637f41fcad31b7ULL},
+    {0xa0d7d42194cb810aULL, 0x1382cc34ca2427c5ULL},
+    {0x67bfb9cf5478ce77ULL, 0x1f37ad21436d0c6fULL},
+    {0x1fcc94a5dd2d71f9ULL, 0x18f9574dcf8a7059ULL},
+    {0x7fd6dd517dbdf4c7ULL, 0x13faac3e3fa1f37aULL},
+    {0xffbe2ee8c92fee0bULL, 0x1ff779fd329cb8c3ULL},
+    {0x6631bf20a0f324d6ULL, 0x1992c7fdc216fa36ULL},
+    {0xb827cc1a1a5c1d78ULL, 0x14756ccb01abfb5eULL},
+    {0x935309ae7b7ce460ULL, 0x105df0a267bcc918ULL},
+    {0x1eeb42b0c594a099ULL, 0x1a2fe76a3f9474f4ULL},
+    {0xe58902270476e6e1ULL, 0x14f31f8832dd2a5cULL},
+    {0xb7a0ce859d2bebe7ULL, 0x10c27fa028b0eeb0ULL},
+    {0x59014a6f61dfdfd8ULL, 0x1ad0cc33744e4ab4ULL},
+    {0xe0cdd525e7e64cadULL, 0x1573d68f903ea229ULL},
+    {0x4d7177518651d6f1ULL, 0x11297872d9cbb4eeULL},
+    {0x7be8bee8d6e957e8ULL, 0x1b758d848fac54b0ULL},
+    {0xfcba3253df211320ULL, 0x15f7a46a0c89dd59ULL},
+    {0x63c8284318e74280ULL, 0x1192e9ee706e4aaeULL},
+    {0x060d0d3827d86a66ULL, 0x1c1e43171a4a1117ULL},
+    {0x6b3da42cecad21ebULL, 0x167e9c127b6e7412ULL},
+    {0x88fe1cf0bd574e56ULL, 0x11fee341fc585cdbULL},
+    {0x419694b462254a23ULL, 0x1ccb0536608d615fULL},
+    {0x67abaa29e81dd4e9ULL, 0x1708d0f84d3de77fULL},
+    {0xb95621bb2017dd87ULL, 0x126d73f9d764b932ULL},
+    {0xc223692b668c95a5ULL, 0x1d7becc2f23ac1eaULL},
+    {0xce82ba891ed6de1dULL, 0x179657025b6234bbULL},
+    {0xa53562074bdf1818ULL, 0x12deac01e2b4f6fcULL},
+    {0x3b889cd87964f359ULL, 0x1e3113363787f194ULL},
+    {0xfc6d4a46c783f5e1ULL, 0x18274291c6065adcULL},
+    {0x30576e9f06032b1aULL, 0x13529ba7d19eaf17ULL},
+    {0x1a257dcb3cd1de90ULL, 0x1eea92a61c311825ULL},
+    {0x481dfe3c30a7e540ULL, 0x18bba884e35a79b7ULL},
+    {0xd34b31c9c0865100ULL, 0x13c9539d82aec7c5ULL},
+    {0x5211e942cda3b4cdULL, 0x1fa885c8d117a609ULL},
+    {0x74db21023e1c90a4ULL, 0x19539e3a40dfb807ULL},
+    {0xf715b401cb4a0d50ULL, 0x1442e4fb67196005ULL},
+    {0xf8de299b09080aa7ULL, 0x103583fc527ab337ULL},
+    {0x8e304291a80cddd7ULL, 0x19ef3993b72ab859ULL},
+    {0x3e8d020e200a4b13ULL, 0x14bf6142f8eef9e1ULL},
+    {0x653d9b3e80083c0fULL, 0x10991a9bfa58c7e7ULL},
+    {0x6ec8f864000d2ce4ULL, 0x1a8e90f9908e0ca5ULL},
+    {0x8bd3f9e999a423eaULL, 0x153eda614071a3b7ULL},
+    {0x3ca994bae1501cbbULL, 0x10ff151a99f482f9ULL},
+    {0xc775bac49bb3612bULL, 0x1b31bb5dc320d18eULL},
+    {0xd2c4956a16291a89ULL, 0x15c162b168e70e0bULL},
+    {0xdbd0778811ba7ba1ULL, 0x11678227871f3e6fULL},
+    {0x2c80bf401c5d929bULL, 0x1bd8d03f3e9863e6ULL},
+    {0xbd33cc3349e47549ULL, 0x16470cff6546b651ULL},
+    {0xca8fd68f6e505dd4ULL, 0x11d270cc51055ea7ULL},
+    {0x4419574be3b3c953ULL, 0x1c83e7ad4e6efdd9ULL},
+    {0x0347790982f63aa9ULL, 0x16cfec8aa52597e1ULL},
+    {0xcf6c60d468c4fbbaULL, 0x123ff06eea847980ULL},
+    {0xe57a34870e07f92aULL, 0x1d331a4b10d3f59aULL},
+    {0x512e906c0b399422ULL, 0x175c1508da432ae2ULL},
+    {0xda8ba6bcd5c7a9b5ULL, 0x12b010d3e1cf5581ULL},
+    {0x90df712e22d90f87ULL, 0x1de6815302e5559cULL},
+    {0xda4c5a8b4f140c6cULL, 0x17eb9aa8cf1dde16ULL},
+    {0xaea37ba2a5a9a38aULL, 0x1322e220a5b17e78ULL},
+    {0x7dd25f6aa2a905a9ULL, 0x1e9e369aa2b59727ULL},
+    {0x97db7f888220d154ULL, 0x187e92154ef7ac1fULL},
+    {0x797c6606ce80a777ULL, 0x139874ddd8c6234cULL},
+    {0x8f2d700ae4010bf1ULL, 0x1f5a549627a36badULL},
+    {0x0c2459a25000d65aULL, 0x191510781fb5efbeULL},
+    {0x701d1481d99a4515ULL, 0x1410d9f9b2f7f2feULL},
+    {0xc017439b147b6a77ULL, 0x100d7b2e28c65bfeULL},
+    {0xccf205c4ed9243f2ULL, 0x19af2b7d0e0a2ccaULL},
+    {0x0a5b37d0be0e9cc2ULL, 0x148c22ca71a1bd6fULL},
+    {0x0848f973cb3ee3ceULL, 0x10701bd527b4978cULL},
+    {0xda0e5bec78649fb0ULL, 0x1a4cf9550c5425acULL},
+    {0x7b3eaff060507fc0ULL, 0x150a6110d6a9b7bdULL},
+    {0x95cbbff380406633ULL, 0x10d51a73deee2c97ULL},
+    {0xefac665266cd7052ULL, 0x1aee90b964b04758ULL},
+    {0x2623850eb8a459dbULL, 0x158ba6fab6f36c47ULL},
+    {0x1e82d0d893b6ae49ULL, 0x113c85955f29236cULL},
+    {0xfd9e1af41f8ab075ULL, 0x1b9408eefea838acULL},
+    {0x97b1af29b2d559f7ULL, 0x16100725988693bdULL},
+    {0xac8e25baf5777b2cULL, 0x11a66c1e139edc97ULL},
+    {0x7a7d092b2258c513ULL, 0x1c3d79c9b8fe2dbfULL},
+    {0x61fda0ef4ead6a76ULL, 0x169794a160cb57ccULL},
+    {0xe7fe1a590bbdeec5ULL, 0x1212dd4de7091309ULL},
+    {0xa6635d5b45fcb13aULL, 0x1ceafbafd80e84dcULL},
+    {0x851c4aaf6b308dc8ULL, 0x172262f3133ed0b0ULL},
+    {0xd0e36ef2bc26d7d4ULL, 0x1281e8c275cbda26ULL},
+    {0xb49f17eac6a48c86ULL, 0x1d9ca79d894629d7ULL},
+    {0x2a18dfef0550706bULL, 0x17b08617a104ee46ULL},
+    {0x54e0b3259dd9f389ULL, 0x12f39e794d9d8b6bULL},
+    {0x87cdeb6f62f65274ULL, 0x1e5297287c2f4578ULL},
+    {0xd30b22bf825ea85dULL, 0x18421286c9bf6ac6ULL},
+    {0x0f3c1bcc684bb9e4ULL, 0x13680ed23aff889fULL},
+    {0x18602c7a4079296dULL, 0x1f0ce4839198da98ULL},
+    {0x46b356c833942124ULL, 0x18d71d360e13e213ULL},
+    {0x388f78a029434db6ULL, 0x13df4a91a4dcb4dcULL},
+    {0x5a7f2766a86baf8aULL, 0x1fcbaa82a1612160ULL},
+    {0x153285ebb9efbfa2ULL, 0x196fbb9bb44db44dULL},
+    {0xaa8ed189618c994eULL, 0x145962e2f6a4903dULL},
+    {0xeed8a7a11ad6e10cULL, 0x1047824f2bb6d9caULL},
+    {0x7e27729b5e249b45ULL, 0x1a0c03b1df8af611ULL},
+    {0xfe85f549181d4904ULL, 0x14d6695b193bf80dULL},
+    {0xcb9e5dd4134aa0d0ULL, 0x10ab877c142ff9a4ULL},
+    {0xdf63c9535211014dULL, 0x1aac0bf9b9e65c3aULL},
+    {0x191ca10f74da6771ULL, 0x15566ffafb1eb02fULL},
+    {0xadb080d92a4852c1ULL, 0x1111f32f2f4bc025ULL},
+    {0x15e7348eaa0d5134ULL, 0x1b4feb7eb212cd09ULL},
+    {0xab1f5d3eee710dc4ULL, 0x15d98932280f0a6dULL},
+    {0xbc1917658b8da49dULL, 0x117ad428200c0857ULL},
+    {0x2cf4f23c127c3a94ULL, 0x1bf7b9d9cce00d59ULL},
+    {0xf0c3f4fcdb969543ULL, 0x165fc7e170b33de0ULL},
+    {0x5a365d9716121103ULL, 0x11e6398126f5cb1aULL},
+    {0x9056fc24f01ce804ULL, 0x1ca38f350b22de90ULL},
+    {0xd9df301d8ce3ecd0ULL, 0x16e93f5da2824ba6ULL},
+    {0xe17f59b13d8323daULL, 0x125432b14ecea2ebULL},
+    {0x68cbc2b52f38395cULL, 0x1d53844ee47dd179ULL},
+    {0x53d6355dbf602de3ULL, 0x177603725064a794ULL},
+    {0xa9782ab165e68b1cULL, 0x12c4cf8ea6b6ec76ULL},
+    {0x0f26aab56fd744faULL, 0x1e07b27dd78b13f1ULL},
+    {0x3f52222abfdf6a62ULL, 0x18062864ac6f4327ULL},
+    {0x65db4e88997f884eULL, 0x1338205089f29c1fULL},
+    {0x6fc54a7428cc0d4aULL, 0x1ec033b40fea9365ULL},
+    {0x596aa1f68709a43bULL, 0x1899c2f673220f84ULL},
+    {0xadeee7f86c07b696ULL, 0x13ae3591f5b4d936ULL},
+    {0x497e3ff3e00c5756ULL, 0x1f7d228322baf524ULL},
+    {0xd464fff64cd6ac45ULL, 0x1930e868e89590e9ULL},
+    {0x4383fff83d7889d1ULL, 0x14272053ed4473eeULL},
+    {0xcf9cccc69793a174ULL, 0x101f4d0ff1038ff1ULL},
+    {0x7f6147a425b90252ULL, 0x19cbae7fe805b31cULL},
+    {0xcc4dd2e9b7c7350fULL, 0x14a2f1ffecd15c16ULL},
+    {0x3d0b0f215fd290d9ULL, 0x10825b3323dab012ULL},
+    {0x61ab4b689950e7c1ULL, 0x1a6a2b85062ab350ULL},
+    {0x4e22a2ba1440b967ULL, 0x1521bc6a6b555c40ULL},
+    {0x0b4ee894dd009453ULL, 0x10e7c9eebc4449cdULL},
+    {0x1217da87c800ed51ULL, 0x1b0c764ac6d3a948ULL},
+    {0xdb46486ca000bddaULL, 0x15a391d56bdc876cULL},
+    {0x490506bd4ccd64afULL, 0x114fa7ddefe39f8aULL},
+    {0xa8080ac87ae23ab1ULL, 0x1bb2a62fe638ff43ULL},
+    {0x5339a239fbe82ef4ULL, 0x162884f31e93ff69ULL},
+    {0x75c7b4fb2fecf25dULL, 0x11ba03f5b20fff87ULL},
+    {0x22d92191e647ea2eULL, 0x1c5cd322b67fff3fULL},
+    {0xb57a8141850654f2ULL, 0x16b0a8e891ffff65ULL},
+    {0xc4620101373843f5ULL, 0x1226ed86db3332b7ULL},
+    {0x3a366801f1f39feeULL, 0x1d0b15a491eb8459ULL},
+    {0xfb5eb99b27f6198bULL, 0x173c115074bc69e0ULL},
+    {0x2f7efae2865e7ad6ULL, 0x129674405d6387e7ULL},
+    {0xe597f7d0d6fd9156ULL, 0x1dbd86cd6238d971ULL},
+    {0x8479930d78cadaabULL, 0x17cad23de82d7ac1ULL},
+    {0xd06142712d6f1556ULL, 0x1308a831868ac89aULL},
+    {0x4d686a4eaf182222ULL, 0x1e74404f3daada91ULL},
+    {0xa453883ef279b4e8ULL, 0x185d003f6488aedaULL},
+    {0xe9dc6cff28615d87ULL, 0x137d99cc506d58aeULL},
+    {0xa960ae650d6895a4ULL, 0x1f2f5c7a1a488de4ULL},
+    {0xbab3beb73ded4483ULL, 0x18f2b061aea07183ULL},
+    {0x2ef6322c318a9d36ULL, 0x13f559e7bee6c136ULL},
+    {0xe4bd1d13827761f0ULL, 0x1feef63f97d79b89ULL},
+    {0x83ca7da9352c4e5aULL, 0x198bf832dfdfafa1ULL},
+    {0x9ca1fe20f756a515ULL, 0x146ff9c24cb2f2e7ULL},
+    {0x4a1b31b3f9121daaULL, 0x1059949b708f28b9ULL},
+    {0x435eb5ecc1b695ddULL, 0x1a28edc580e50df5ULL},
+    {0x35e55e57015ede4aULL, 0x14ed8b04671da4c4ULL},
+    {0xc4b77eac0118b1d5ULL, 0x10be08d0527e1d69ULL},
+    {0xa12597799b5ab622ULL, 0x1ac9a7b3b7302f0fULL},
+    {0x4db7ac6149155e81ULL, 0x156e1fc2f8f358d9ULL},
+    {0xd7c6238107444b9bULL, 0x1124e63593f5e0adULL},
+    {0x593d059b3ed3ac2bULL, 0x1b6e3d2286563449ULL},
+    {0xe0fd9e15cbdc89bcULL, 0x15f1ca820511c36dULL},
+    {0xb3fe18116fe3a163ULL, 0x118e3b9b37416924ULL},
+    {0x866359b57fd29bd1ULL, 0x1c16c5c525357507ULL},
+    {0xd1e91491330ee30eULL, 0x16789e3750f790d2ULL},
+    {0x74ba76da8f3f1c0bULL, 0x11fa182c40c60d75ULL},
+    {0xedf72490e531c678ULL, 0x1cc359e067a348bbULL},
+    {0x8b2c1d40b75b052dULL, 0x1702ae4d1fb5d3c9ULL},
+    {0x6f567dcd5f7c0424ULL, 0x12688b70e62b0fd4ULL},
+    {0x7ef0c94898c66d06ULL, 0x1d74124e3d11b2edULL},
+    {0x98c0a106e09ebd9fULL, 0x17900ea4fda7c257ULL},
+    {0x470080d24d4bcae6ULL, 0x12d9a550caec9b79ULL},
+    {0xd800ce1d487944a2ULL, 0x1e29088144adc58eULL},
+    {0x1333d8176d2dd082ULL, 0x1820d39a9d57d13fULL},
+    {0xa8f646792424a6ceULL, 0x134d76154aaca765ULL},
+    {0x74bd3d8ea03aa47dULL, 0x1ee25688777aa56fULL},
+    {0x5d64313ee6955064ULL, 0x18b51206c5fbb78cULL},
+    {0x4ab68dcbebaaa6b7ULL, 0x13c40e6bd1962c70ULL},
+    {0x1124161312aaa457ULL, 0x1fa01712e8f0471aULL},
+    {0xda8344dc0eeee9dfULL, 0x194cdf4253f36c14ULL},
+    {0xe2029d7cd8bf2180ULL, 0x143d7f6843292343ULL},
+    {0x4e687dfd7a328133ULL, 0x103132b9cf541c36ULL},
+    {0x4a40c9959050ceb8ULL, 0x19e851294bb9c6bdULL},
+    {0x0833d477a6a70bc6ULL, 0x14b9da876fc7d231ULL},
+    {0xa02976c61eec096bULL, 0x1094aed2bfd30e8dULL},
+    {0x004257a364acdbdfULL, 0x1a877e1dffb81749ULL},
+    {0xcd01dfb5ea23e319ULL, 0x153931b1996012a0ULL},
+    {0x70ce4c91881cb5aeULL, 0x10fa8e27ade6754dULL},
+    {0x1ae3adb5a69455e2ULL, 0x1b2a7d0c4970bbafULL},
+    {0x7be957c4854377e8ULL, 0x15bb973d078d62f2ULL},
+    {0xc987796a0435f987ULL, 0x1162df64060ab58eULL},
+    {0x75a58f1006bcc271ULL, 0x1bd1656cd67788e4ULL},
+    {0xf7b7a5a66bca3527ULL, 0x16411df0ab92d3e9ULL},
+    {0x5fc61e1ebca1c41fULL, 0x11cdb18d560f0feeULL},
+    {0xffa363646102d365ULL, 0x1c7c4f4889b1b316ULL},
+    {0x32e91c504d9bdc51ULL, 0x16c9d906d48e28dfULL},
+    {0x8f20e37371497d0eULL, 0x123b140576d820b2ULL},
+    {0x7e9b0585820f2e7cULL, 0x1d2b533bf159cdeaULL},
+    {0xcbaf379e01a5becaULL, 0x1755dc2ff447d7eeULL},
+    {0x0958f94b348498a1ULL, 0x12ab168cc36cacbfULL},
+};
+
+static const uint64_t pow5_split[][2] = {
+    {0x0000000000000000ULL, 0x1000000000000000ULL},
+    {0x0000000000000000ULL, 0x1400000000000000ULL},
+    {0x0000000000000000ULL, 0x1900000000000000ULL},
+    {0x0000000000000000ULL, 0x1f40000000000000ULL},
+    {0x0000000000000000ULL, 0x1388000000000000ULL},
+    {0x0000000000000000ULL, 0x186a000000000000ULL},
+    {0x0000000000000000ULL, 0x1e84800000000000ULL},
+    {0x0000000000000000ULL, 0x1312d00000000000ULL},
+    {0x0000000000000000ULL, 0x17d7840000000000ULL},
+    {0x0000000000000000ULL, 0x1dcd650000000000ULL},
+    {0x0000000000000000ULL, 0x12a05f2000000000ULL},
+    {0x0000000000000000ULL, 0x174876e800000000ULL},
+    {0x0000000000000000ULL, 0x1d1a94a200000000ULL},
+    {0x0000000000000000ULL, 0x12309ce540000000ULL},
+    {0x0000000000000000ULL, 0x16bcc41e90000000ULL},
+    {0x0000000000000000ULL, 0x1c6bf52634000000ULL},
+    {0x0000000000000000ULL, 0x11c37937e0800000ULL},
+    {0x0000000000000000ULL, 0x16345785d8a00000ULL},
+    {0x0000000000000000ULL, 0x1bc16d674ec80000ULL},
+    {0x0000000000000000ULL, 0x1158e460913d0000ULL},
+    {0x0000000000000000ULL, 0x15af1d78b58c4000ULL},
+    {0x0000000000000000ULL, 0x1b1ae4d6e2ef5000ULL},
+    {0x0000000000000000ULL, 0x10f0cf064dd59200ULL},
+    {0x0000000000000000ULL, 0x152d02c7e14af680ULL},
+    {0x0000000000000000ULL, 0x1a784379d99db420ULL},
+    {0x0000000000000000ULL, 0x108b2a2c28029094ULL},
+    {0x0000000000000000ULL, 0x14adf4b7320334b9ULL},
+    {0x4000000000000000ULL, 0x19d971e4fe8401e7ULL},
+    {0x8800000000000000ULL, 0x1027e72f1f128130ULL},
+    {0xaa00000000000000ULL, 0x1431e0fae6d7217cULL},
+    {0xd480000000000000ULL, 0x193e5939a08ce9dbULL},
+    {0xc9a0000000000000ULL, 0x1f8def8808b02452ULL},
+    {0xbe04000000000000ULL, 0x13b8b5b5056e16b3ULL},
+    {0xad85000000000000ULL, 0x18a6e32246c99c60ULL},
+    {0xd8e6400000000000ULL, 0x1ed09bead87c0378ULL},
+    {0x878fe80000000000ULL, 0x13426172c74d822bULL},
+    {0x6973e20000000000ULL, 0x1812f9cf7920e2b6ULL},
+    {0x03d0da8000000000ULL, 0x1e17b84357691b64ULL},
+    {0x8262889000000000ULL, 0x12ced32a16a1b11eULL},
+    {0x22fb2ab400000000ULL, 0x178287f49c4a1d66ULL},
+    {0xabb9f56100000000ULL, 0x1d6329f1c35ca4bfULL},
+    {0xcb54395ca0000000ULL, 0x125dfa371a19e6f7ULL},
+    {0xbe2947b3c8000000ULL, 0x16f578c4e0a060b5ULL},
+    {0x2db399a0ba000000ULL, 0x1cb2d6f618c878e3ULL},
+    {0xfc90400474400000ULL, 0x11efc659cf7d4b8dULL},
+    {0x7bb4500591500000ULL, 0x166bb7f0435c9e71ULL},
+    {0xdaa16406f5a40000ULL, 0x1c06a5ec5433c60dULL},
+    {0xa8a4de8459868000ULL, 0x118427b3b4a05bc8ULL},
+    {0xd2ce16256fe82000ULL, 0x15e531a0a1c872baULL},
+    {0x87819baecbe22800ULL, 0x1b5e7e08ca3a8f69ULL},
+    {0xf4b1014d3f6d5900ULL, 0x111b0ec57e6499a1ULL},
+    {0x71dd41a08f48af40ULL, 0x1561d276ddfdc00aULL},
+    {0x0e549208b31adb10ULL, 0x1aba4714957d300dULL},
+    {0x28f4db456ff0c8eaULL, 0x10b46c6cdd6e3e08ULL},
+    {0x33321216cbecfb24ULL, 0x14e1878814c9cd8aULL},
+    {0xbffe969c7ee839edULL, 0x1a19e96a19fc40ecULL},
+    {0xf7ff1e21cf512434ULL, 0x105031e2503da893ULL},
+    {0xf5fee5aa43256d41ULL, 0x14643e5ae44d12b8ULL},
+    {0x337e9f14d3eec892ULL, 0x197d4df19d605767ULL},
+    {0x005e46da08ea7ab6ULL, 0x1fdca16e04b86d41ULL},
+    {0xa03aec4845928cb2ULL, 0x13e9e4e4c2f34448ULL},
+    {0xc849a75a56f72fdeULL, 0x18e45e1df3b0155aULL},
+    {0x7a5c1130ecb4fbd6ULL, 0x1f1d75a5709c1ab1ULL},
+    {0xec798abe93f11d65ULL, 0x13726987666190aeULL},
+    {0xa797ed6e38ed64bfULL, 0x184f03e93ff9f4daULL},
+    {0x517de8c9c728bdefULL, 0x1e62c4e38ff87211ULL},
+    {0xd2eeb17e1c7976b5ULL, 0x12fdbb0e39fb474aULL},
+    {0x87aa5ddda397d462ULL, 0x17bd29d1c87a191dULL},
+    {0xe994f5550c7dc97bULL, 0x1dac74463a989f64ULL},
+    {0x11fd195527ce9dedULL, 0x128bc8abe49f639fULL},
+    {0xd67c5faa71c24568ULL, 0x172ebad6ddc73c86ULL},
+    {0x8c1b77950e32d6c2ULL, 0x1cfa698c95390ba8ULL},
+    {0x57912abd28dfc639ULL, 0x121c81f7dd43a749ULL},
+    {0xad75756c7317b7c8ULL, 0x16a3a275d494911bULL},
+    {0x98d2d2c78fdda5baULL, 0x1c4c8b1349b9b562ULL},
+    {0x9f83c3bcb9ea8794ULL, 0x11afd6ec0e14115dULL},
+    {0x0764b4abe8652979ULL, 0x161bcca7119915b5ULL},
+    {0x493de1d6e27e73d7ULL, 0x1ba2bfd0d5ff5b22ULL},
+    {0x6dc6ad264d8f0866ULL, 0x1145b7e285bf98f5ULL},
+    {0xc938586fe0f2ca80ULL, 0x159725db272f7f32ULL},
+    {0x7b866e8bd92f7d20ULL, 0x1afcef51f0fb5effULL},
+    {0xad34051767bdae34ULL, 0x10de1593369d1b5fULL},
+    {0x9881065d41ad19c1ULL, 0x15159af804446237ULL},
+    {0x7ea147f492186032ULL, 0x1a5b01b605557ac5ULL},
+    {0x6f24ccf8db4f3c1fULL, 0x1078e111c3556cbbULL},
+    {0x4aee003712230b27ULL, 0x14971956342ac7eaULL},
+    {0xdda98044d6abcdf0ULL, 0x19bcdfabc13579e4ULL},
+    {0x0a89f02b062b60b6ULL, 0x10160bcb58c16c2fULL},
+    {0xcd2c6c35c7b638e4ULL, 0x141b8ebe2ef1c73aULL},
+    {0x8077874339a3c71dULL, 0x1922726dbaae3909ULL},
+    {0xe0956914080cb8e4ULL, 0x1f6b0f092959c74bULL},
+    {0x6c5d61ac8507f38eULL, 0x13a2e965b9d81c8fULL},
+    {0x4774ba17a649f072ULL, 0x188ba3bf284e23b3ULL},
+    {0x1951e89d8fdc6c8fULL, 0x1eae8caef261aca0ULL},
+    {0x0fd3316279e9c3d9ULL, 0x132d17ed577d0be4ULL},
+    {0x13c7fdbb186434cfULL, 0x17f85de8ad5c4eddULL},
+    {0x58b9fd29de7d4203ULL, 0x1df67562d8b36294ULL},
+    {0xb7743e3a2b0e4942ULL, 0x12ba095dc7701d9cULL},
+    {0xe5514dc8b5d1db92ULL, 0x17688bb5394c2503ULL},
+    {0xdea5a13ae3465277ULL, 0x1d42aea2879f2e44ULL},
+    {0x0b2784c4ce0bf38aULL, 0x1249ad2594c37cebULL},
+    {0xcdf165f6018ef06dULL, 0x16dc186ef9f45c25ULL},
+    {0x416dbf7381f2ac88ULL, 0x1c931e8ab871732fULL},
+    {0x88e497a83137abd5ULL, 0x11dbf316b346e7fdULL},
+    {0xeb1dbd923d8596caULL, 0x1652efdc6018a1fcULL},
+    {0x25e52cf6cce6fc7dULL, 0x1be7abd3781eca7cULL},
+    {0x97af3c1a40105dceULL, 0x1170cb642b133e8dULL},
+    {0xfd9b0b20d0147542ULL, 0x15ccfe3d35d80e30ULL},
+    {0x3d01cde904199292ULL, 0x1b403dcc834e11bdULL},
+    {0x462120b1a28ffb9bULL, 0x1108269fd210cb16ULL},
+    {0xd7a968de0b33fa82ULL, 0x154a3047c694fddbULL},
+    {0xcd93c3158e00f923ULL, 0x1a9cbc59b83a3d52ULL},
+    {0xc07c59ed78c09bb6ULL, 0x10a1f5b813246653ULL},
+    {0xb09b7068d6f0c2a3ULL, 0x14ca732617ed7fe8ULL},
+    {0xdcc24c830cacf34cULL, 0x19fd0fef9de8dfe2ULL},
+    {0xc9f96fd1e7ec180fULL, 0x103e29f5c2b18bedULL},
+    {0x3c77cbc661e71e13ULL, 0x144db473335deee9ULL},
+    {0x8b95beb7fa60e598ULL, 0x1961219000356aa3ULL},
+    {0x6e7b2e65f8f91efeULL, 0x1fb969f40042c54cULL},
+    {0xc50cfcffbb9bb35fULL, 0x13d3e2388029bb4fULL},
+    {0xb6503c3faa82a037ULL, 0x18c8dac6a0342a23ULL},
+    {0xa3e44b4f95234844ULL, 0x1efb1178484134acULL},
+    {0xe66eaf11bd360d2bULL, 0x135ceaeb2d28c0ebULL},
+    {0xe00a5ad62c839075ULL, 0x183425a5f872f126ULL},
+    {0x980cf18bb7a47493ULL, 0x1e412f0f768fad70ULL},
+    {0x5f0816f752c6c8dcULL, 0x12e8bd69aa19cc66ULL},
+    {0xf6ca1cb527787b13ULL, 0x17a2ecc414a03f7fULL},
+    {0xf47ca3e2715699d7ULL, 0x1d8ba7f519c84f5fULL},
+    {0xf8cde66d86d62026ULL, 0x127748f9301d319bULL},
+    {0xf7016008e88ba830ULL, 0x17151b377c247e02ULL},
+    {0xb4c1b80b22ae923cULL, 0x1cda62055b2d9d83ULL},
+    {0x50f91306f5ad1b65ULL, 0x12087d4358fc8272ULL},
+    {0xe53757c8b318623fULL, 0x168a9c942f3ba30eULL},
+    {0x9e852dbadfde7acfULL, 0x1c2d43b93b0a8bd2ULL},
+    {0xa3133c94cbeb0cc1ULL, 0x119c4a53c4e69763ULL},
+    {0x8bd80bb9fee5cff1ULL, 0x16035ce8b6203d3cULL},
+    {0xaece0ea87e9f43eeULL, 0x1b843422e3a84c8bULL},
+    {0x4d40c9294f238a75ULL, 0x1132a095ce492fd7ULL},
+    {0x2090fb73a2ec6d12ULL, 0x157f48bb41db7bcdULL},
+    {0x68b53a508ba78856ULL, 0x1adf1aea12525ac0ULL},
+    {0x417144725748b536ULL, 0x10cb70d24b7378b8ULL},
+    {0x51cd958eed1ae283ULL, 0x14fe4d06de5056e6ULL},
+    {0xe640faf2a8619b24ULL, 0x1a3de04895e46c9fULL},
+    {0xefe89cd7a93d00f7ULL, 0x1066ac2d5daec3e3ULL},
+    {0xebe2c40d938c4134ULL, 0x14805738b51a74dcULL},
+    {0x26db7510f86f5181ULL, 0x19a06d06e2611214ULL},
+    {0x9849292a9b4592f1ULL, 0x100444244d7cab4cULL},
+    {0xbe5b73754216f7adULL, 0x1405552d60dbd61fULL},
+    {0xadf25052929cb598ULL, 0x1906aa78b912cba7ULL},
+    {0x996ee4673743e2ffULL, 0x1f485516e7577e91ULL},
+    {0xffe54ec0828a6ddfULL, 0x138d352e5096af1aULL},
+    {0xbfdea270a32d0957ULL, 0x18708279e4bc5ae1ULL},
+    {0x2fd64b0ccbf84badULL, 0x1e8ca3185deb719aULL},
+    {0x5de5eee7ff7b2f4cULL, 0x1317e5ef3ab32700ULL},
+    {0x755f6aa1ff59fb1fULL, 0x17dddf6b095ff0c0ULL},
+    {0x92b7454a7f3079e7ULL, 0x1dd55745cbb7ecf0ULL},
+    {0x5bb28b4e8f7e4c30ULL, 0x12a5568b9f52f416ULL},
+    {0xf29f2e22335ddf3cULL, 0x174eac2e8727b11bULL},
+    {0xef46f9aac035570bULL, 0x1d22573a28f19d62ULL},
+    {0xd58c5c0ab8215667ULL, 0x123576845997025dULL},
+    {0x4aef730d6629ac01ULL, 0x16c2d4256ffcc2f5ULL},
+    {0x9dab4fd0bfb41701ULL, 0x1c73892ecbfbf3b2ULL},
+    {0xa28b11e277d08e60ULL, 0x11c835bd3f7d784fULL},
+    {0x8b2dd65b15c4b1f9ULL, 0x163a432c8f5cd663ULL},
+    {0x6df94bf1db35de77ULL, 0x1bc8d3f7b3340bfcULL},
+    {0xc4bbcf772901ab0aULL, 0x115d847ad000877dULL},
+    {0x35eac354f34215cdULL, 0x15b4e5998400a95dULL},
+    {0x8365742a30129b40ULL, 0x1b221effe500d3b4ULL},
+    {0xd21f689a5e0ba108ULL, 0x10f5535fef208450ULL},
+    {0x06a742c0f58e894aULL, 0x1532a837eae8a565ULL},
+    {0x4851137132f22b9dULL, 0x1a7f5245e5a2cebeULL},
+    {0xed32ac26bfd75b42ULL, 0x108f936baf85c136ULL},
+    {0xa87f57306fcd3212ULL, 0x14b378469b673184ULL},
+    {0xd29f2cfc8bc07e97ULL, 0x19e056584240fde5ULL},
+    {0xa3a37c1dd7584f1eULL, 0x102c35f729689eafULL},
+    {0x8c8c5b254d2e62e6ULL, 0x14374374f3c2c65bULL},
+    {0x6faf71eea079fb9fULL, 0x1945145230b377f2ULL},
+    {0x0b9b4e6a48987a87ULL, 0x1f965966bce055efULL},
+    {0x674111026d5f4c94ULL, 0x13bdf7e0360c35b5ULL},
+    {0xc111554308b71fbaULL, 0x18ad75d8438f4322ULL},
+    {0x7155aa93cae4e7a8ULL, 0x1ed8d34e547313ebULL},
+    {0x26d58a9c5ecf10c9ULL, 0x13478410f4c7ec73ULL},
+    {0xf08aed437682d4fbULL, 0x1819651531f9e78fULL},
+    {0xecada89454238a3aULL, 0x1e1fbe5a7e786173ULL},
+    {0x73ec895cb4963664ULL, 0x12d3d6f88f0b3ce8ULL},
+    {0x90e7abb3e1bbc3fdULL, 0x1788ccb6b2ce0c22ULL},
+    {0x352196a0da2ab4fdULL, 0x1d6affe45f818f2bULL},
+    {0x0134fe24885ab11eULL, 0x1262dfeebbb0f97bULL},
+    {0xc1823dadaa715d65ULL, 0x16fb97ea6a9d37d9ULL},
+    {0x31e2cd19150db4bfULL, 0x1cba7de5054485d0ULL},
+    {0x1f2dc02fad2890f7ULL, 0x11f48eaf234ad3a2ULL},
+    {0xa6f9303b9872b535ULL, 0x1671b25aec1d888aULL},
+    {0x50b77c4a7e8f6282ULL, 0x1c0e1ef1a724eaadULL},
+    {0x5272adae8f199d91ULL, 0x1188d357087712acULL},
+    {0x670f591a32e004f6ULL, 0x15eb082cca94d757ULL},
+    {0x40d32f60bf980633ULL, 0x1b65ca37fd3a0d2dULL},
+    {0x4883fd9c77bf03e0ULL, 0x111f9e62fe44483cULL},
+    {0x5aa4fd0395aec4d8ULL, 0x156785fbbdd55a4bULL},
+    {0x314e3c447b1a760eULL, 0x1ac1677aad4ab0deULL},
+    {0xded0e5aaccf089c9ULL, 0x10b8e0acac4eae8aULL},
+    {0x96851f15802cac3bULL, 0x14e718d7d7625a2dULL},
+    {0xfc2666dae037d74aULL, 0x1a20df0dcd3af0b8ULL},
+    {0x9d980048cc22e68eULL, 0x10548b68a044d673ULL},
+    {0x84fe005aff2ba032ULL, 0x1469ae42c8560c10ULL},
+    {0xa63d8071bef6883eULL, 0x198419d37a6b8f14ULL},
+    {0xcfcce08e2eb42a4eULL, 0x1fe52048590672d9ULL},
+    {0x21e00c58dd309a70ULL, 0x13ef342d37a407c8ULL},
+    {0x2a580f6f147cc10dULL, 0x18eb0138858d09baULL},
+    {0xb4ee134ad99bf150ULL, 0x1f25c186a6f04c28ULL},
+    {0x7114cc0ec80176d2ULL, 0x137798f428562f99ULL},
+    {0xcd59ff127a01d486ULL, 0x18557f31326bbb7fULL},
+    {0xc0b07ed7188249a8ULL, 0x1e6adefd7f06aa5fULL},
+    {0xd86e4f466f516e09ULL, 0x1302cb5e6f642a7bULL},
+    {0xce89e3180b25c98bULL, 0x17c37e360b3d351aULL},
+    {0x822c5bde0def3beeULL, 0x1db45dc38e0c8261ULL},
+    {0xf15bb96ac8b58575ULL, 0x1290ba9a38c7d17cULL},
+    {0x2db2a7c57ae2e6d2ULL, 0x1734e940c6f9c5dcULL},
+    {0x391f51b6d99ba086ULL, 0x1d022390f8b83753ULL},
+    {0x03b3931248014454ULL, 0x1221563a9b732294ULL},
+    {0x04a077d6da019569ULL, 0x16a9abc9424feb39ULL},
+    {0x45c895cc9081fac3ULL, 0x1c5416bb92e3e607ULL},
+    {0x8b9d5d9fda513cbaULL, 0x11b48e353bce6fc4ULL},
+    {0xae84b507d0e58be8ULL, 0x1621b1c28ac20bb5ULL},
+    {0x1a25e249c51eeee3ULL, 0x1baa1e332d728ea3ULL},
+    {0xf057ad6e1b33554dULL, 0x114a52dffc679925ULL},
+    {0x6c6d98c9a2002aa1ULL, 0x159ce797fb817f6fULL},
+    {0x4788fefc0a803549ULL, 0x1b04217dfa61df4bULL},
+    {0x0cb59f5d8690214eULL, 0x10e294eebc7d2b8fULL},
+    {0xcfe30734e83429a1ULL, 0x151b3a2a6b9c7672ULL},
+    {0x83dbc9022241340aULL, 0x1a6208b50683940fULL},
+    {0xb2695da15568c086ULL, 0x107d457124123c89ULL},
+    {0x1f03b509aac2f0a7ULL, 0x149c96cd6d16cbacULL},
+    {0x26c4a24c1573acd1ULL, 0x19c3bc80c85c7e97ULL},
+    {0x783ae56f8d684c03ULL, 0x101a55d07d39cf1eULL},
+    {0x16499ecb70c25f03ULL, 0x1420eb449c8842e6ULL},
+    {0x9bdc067e4cf2f6c4ULL, 0x19292615c3aa539fULL},
+    {0x82d3081de02fb476ULL, 0x1f736f9b3494e887ULL},
+    {0xb1c3e512ac1dd0c9ULL, 0x13a825c100dd1154ULL},
+    {0xde34de57572544fcULL, 0x18922f31411455a9ULL},
+    {0x55c215ed2cee963bULL, 0x1eb6bafd91596b14ULL},
+    {0xb5994db43c151de5ULL, 0x133234de7ad7e2ecULL},
+    {0xe2ffa1214b1a655eULL, 0x17fec216198ddba7ULL},
+    {0xdbbf89699de0feb6ULL, 0x1dfe729b9ff15291ULL},
+    {0x2957b5e202ac9f31ULL, 0x12bf07a143f6d39bULL},
+    {0xf3ada35a8357c6feULL, 0x176ec98994f48881ULL},
+    {0x70990c31242db8bdULL, 0x1d4a7bebfa31aaa2ULL},
+    {0x865fa79eb69c9376ULL, 0x124e8d737c5f0aa5ULL},
+    {0xe7f791866443b854ULL, 0x16e230d05b76cd4eULL},
+    {0xa1f575e7fd54a669ULL, 0x1c9abd04725480a2ULL},
+    {0xa53969b0fe54e801ULL, 0x11e0b622c774d065ULL},
+    {0x0e87c41d3dea2202ULL, 0x1658e3ab7952047fULL},
+    {0xd229b5248d64aa82ULL, 0x1bef1c9657a6859eULL},
+    {0x435a1136d85eea91ULL, 0x117571ddf6c81383ULL},
+    {0x143095848e76a536ULL, 0x15d2ce55747a1864ULL},
+    {0x193cbae5b2144e83ULL, 0x1b4781ead1989e7dULL},
+    {0x2fc5f4cf8f4cb112ULL, 0x110cb132c2ff630eULL},
+    {0xbbb77203731fdd56ULL, 0x154fdd7f73bf3bd1ULL},
+    {0x2aa54e844fe7d4acULL, 0x1aa3d4df50af0ac6ULL},
+    {0xdaa75112b1f0e4ebULL, 0x10a6650b926d66bbULL},
+    {0xd15125575e6d1e26ULL, 0x14cffe4e7708c06aULL},
+    {0x85a56ead360865b0ULL, 0x1a03fde214caf085ULL},
+    {0x7387652c41c53f8eULL, 0x10427ead4cfed653ULL},
+    {0x50693e7752368f71ULL, 0x14531e58a03e8be8ULL},
+    {0x64838e1526c4334eULL, 0x1967e5eec84e2ee2ULL},
+    {0xfda4719a70754022ULL, 0x1fc1df6a7a61ba9aULL},
+    {0xde86c70086494815ULL, 0x13d92ba28c7d14a0ULL},
+    {0x162878c0a7db9a1aULL, 0x18cf768b2f9c59c9ULL},
+    {0x5bb296f0d1d280a1ULL, 0x1f03542dfb83703bULL},
+    {0x194f9e5683239064ULL, 0x1362149cbd322625ULL},
+    {0x5fa385ec23ec747eULL, 0x183a99c3ec7eafaeULL},
+    {0xf78c67672ce7919dULL, 0x1e494034e79e5b99ULL},
+    {0x3ab7c0a07c10bb02ULL, 0x12edc82110c2f940ULL},
+    {0x4965b0c89b14e9c3ULL, 0x17a93a2954f3b790ULL},
+    {0x5bbf1cfac1da2433ULL, 0x1d9388b3aa30a574ULL},
+    {0xb957721cb92856a0ULL, 0x127c35704a5e6768ULL},
+    {0xe7ad4ea3e7726c48ULL, 0x171b42cc5cf60142ULL},
+    {0xa198a24ce14f075aULL, 0x1ce2137f74338193ULL},
+    {0x44ff65700cd16498ULL, 0x120d4c2fa8a030fcULL},
+    {0x563f3ecc1005bdbeULL, 0x16909f3b92c83d3bULL},
+    {0x2bcf0e7f14072d2eULL, 0x1c34c70a777a4c8aULL},
+    {0x5b61690f6c847c3dULL, 0x11a0fc668aac6fd6ULL},
+    {0xf239c35347a59b4cULL, 0x16093b802d578bcbULL},
+    {0xeec83428198f021fULL, 0x1b8b8a6038ad6ebeULL},
+    {0x553d20990ff96153ULL, 0x1137367c236c6537ULL},
+    {0x2a8c68bf53f7b9a8ULL, 0x1585041b2c477e85ULL},
+    {0x752f82ef28f5a812ULL, 0x1ae64521f7595e26ULL},
+    {0x093db1d57999890bULL, 0x10cfeb353a97dad8ULL},
+    {0x0b8d1e4ad7ffeb4eULL, 0x1503e602893dd18eULL},
+    {0x8e7065dd8dffe622ULL, 0x1a44df832b8d45f1ULL},
+    {0xf9063faa78bfefd5ULL, 0x106b0bb1fb384bb6ULL},
+    {0xb747cf9516efebcaULL, 0x1485ce9e7a065ea4ULL},
+    {0xe519c37a5cabe6bdULL, 0x19a742461887f64dULL},
+    {0xaf301a2c79eb7036ULL, 0x1008896bcf54f9f0ULL},
+    {0xdafc20b798664c43ULL, 0x140aabc6c32a386cULL},
+    {0x11bb28e57e7fdf54ULL, 0x190d56b873f4c688ULL},
+    {0x1629f31ede1fd72aULL, 0x1f50ac6690f1f82aULL},
+    {0x4dda37f34ad3e67aULL, 0x13926bc01a973b1aULL},
+    {0xe150c5f01d88e019ULL, 0x187706b0213d09e0ULL},
+    {0x19a4f76c24eb181fULL, 0x1e94c85c298c4c59ULL},
+    {0xb0071aa39712ef13ULL, 0x131cfd3999f7afb7ULL},
+    {0x9c08e14c7cd7aad8ULL, 0x17e43c8800759ba5ULL},
+    {0x030b199f9c0d958eULL, 0x1ddd4baa0093028fULL},
+    {0x61e6f003c1887d79ULL, 0x12aa4f4a405be199ULL},
+    {0xba60ac04b1ea9cd7ULL, 0x1754e31cd072d9ffULL},
+    {0xa8f8d705de65440dULL, 0x1d2a1be4048f907fULL},
+    {0xc99b8663aaff4a88ULL, 0x123a516e82d9ba4fULL},
+    {0xbc0267fc95bf1d2aULL, 0x16c8e5ca239028e3ULL},
+    {0xab0301fbbb2ee474ULL, 0x1c7b1f3cac74331cULL},
+    {0xeae1e13d54fd4ec9ULL, 0x11ccf385ebc89ff1ULL},
+    {0x659a598caa3ca27bULL, 0x1640306766bac7eeULL},
+    {0xff00efefd4cbcb1aULL, 0x1bd03c81406979e9ULL},
+    {0x3f6095f5e4ff5ef0ULL, 0x116225d0c841ec32ULL},
+    {0xcf38bb735e3f36acULL, 0x15baaf44fa52673eULL},
+    {0x8306ea5035cf0457ULL, 0x1b295b1638e7010eULL},
+    {0x11e4527221a162b6ULL, 0x10f9d8ede39060a9ULL},
+    {0x565d670eaa09bb64ULL, 0x15384f295c7478d3ULL},
+    {0x2bf4c0d2548c2a3dULL, 0x1a8662f3b3919708ULL},
+    {0x1b78f88374d79a66ULL, 0x1093fdd8503afe65ULL},
+    {0x625736a4520d8100ULL, 0x14b8fd4e6449bdfeULL},
+    {0xfaed044d6690e140ULL, 0x19e73ca1fd5c2d7dULL},
+    {0xbcd422b0601a8cc8ULL, 0x103085e53e599c6eULL},
+    {0x6c092b5c78212ffaULL, 0x143ca75e8df0038aULL},
+    {0x070b763396297bf8ULL, 0x194bd136316c046dULL},
+    {0x48ce53c07bb3daf6ULL, 0x1f9ec583bdc70588ULL},
+    {0x2d80f4584d5068daULL, 0x13c33b72569c6375ULL},
+    {0x78e1316e60a48310ULL, 0x18b40a4eec437c52ULL},
+};
+
+//ceil(log2(5^e)) for e > 0, 1 for e == 0
+static inline int32_t pow5bits(int32_t e){
+    return static_cast<int32_t>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
+}
+//floor(log10(2^e))
+static inline uint32_t log10_pow2(int32_t e){
+    return (static_cast<uint32_t>(e) * 78913) >> 18;
+}
+//floor(log10(5^e))
+static inline uint32_t log10_pow5(int32_t e){
+    return (static_cast<uint32_t>(e) * 732923) >> 20;
+}
+
+static inline bool multiple_of_power_of_5(uint64_t value, uint32_t p){
+    uint32_t count = 0;
+    for (; value % 5 == 0; value /= 5)
+        ++count;
+    return count >= p;
+}
+static inline bool multiple_of_power_of_2(uint64_t value, uint32_t p){
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+//(m * mul) >> j, with 64 < j < 128
+static inline uint64_t mul_shift(uint64_t m, const uint64_t *mul, int32_t j){
+    uint64_t high0, low0, high1, low1;
+    full_multiplication(m, mul[0], high0, low0);
+    full_multiplication(m, mul[1], high1, low1);
+    uint64_t low = low1 + high0;
+    uint64_t high = high1 + (low < low1);
+    int32_t shift = j - 64;
+    return (high << (64 - shift)) | (low >> shift);
+}
+
+//the shortest decimal mantissa * 10^exponent inside the rounding interval of a finite, nonzero double
+static void shortest_decimal(uint64_t ieee_mantissa, uint32_t ieee_exponent, uint64_t &mantissa, int32_t &exponent){
+    const int mantissa_bits = 52, bias = 1023;
+    int32_t e2;
+    uint64_t m2;
+    //two extra bits, so that the interval bounds are integers too
+    if (ieee_exponent == 0){
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    }
+    else {
+        e2 = static_cast<int32_t>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (uint64_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    //the interval is [mm, mp] around mv, narrower below at powers of two
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_trailing_zeros = false, vr_trailing_zeros = false;
+    if (e2 >= 0){
+        const uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = static_cast<int32_t>(q);
+        const int32_t k = pow5_inv_bitcount + pow5bits(static_cast<int32_t>(q)) - 1;
+        const int32_t i = -e2 + static_cast<int32_t>(q) + k;
+        vr = mul_shift(mv, pow5_inv_split[q], i);
+        vp = mul_shift(mv + 2, pow5_inv_split[q], i);
+        vm = mul_shift(mv - 1 - mm_shift, pow5_inv_split[q], i);
+        if (q <= 21){
+            //at most one of mm, mv and mp is a multiple of 5
+            if (mv % 5 == 0)
+                vr_trailing_zeros = multiple_of_power_of_5(mv, q);
+            else if (accept_bounds)
+                vm_trailing_zeros = multiple_of_power_of_5(mv - 1 - mm_shift, q);
+            else
+                vp -= multiple_of_power_of_5(mv + 2, q);
+        }
+    }
+    else {
+        const uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = static_cast<int32_t>(q) + e2;
+        const int32_t i = -e2 - static_cast<int32_t>(q);
+        const int32_t k = pow5bits(i) - pow5_bitcount;
+        const int32_t j = static_cast<int32_t>(q) - k;
+        vr = mul_shift(mv, pow5_split[i], j);
+        vp = mul_shift(mv + 2, pow5_split[i], j);
+        vm = mul_shift(mv - 1 - mm_shift, pow5_split[i], j);
+        if (q <= 1){
+            //mv has at least two trailing zero bits, mm one exactly when mm_shift is set
+            vr_trailing_zeros = true;
+            if (accept_bounds)
+                vm_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        }
+        else if (q < 63)
+            vr_trailing_zeros = multiple_of_power_of_2(mv, q);
+    }
+
+    //drop digits while the interval still holds a shorter number
+    int32_t removed = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros){
+        //rare: the exact value of a bound or of the tie matters
+        unsigned last_removed = 0;
+        while (vp / 10 > vm / 10){
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = static_cast<unsigned>(vr % 10);
+            vr /= 10; vp /= 10; vm /= 10;
+            ++removed;
+        }
+        if (vm_trailing_zeros){
+            while (vm % 10 == 0){
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = static_cast<unsigned>(vr % 10);
+                vr /= 10; vp /= 10; vm /= 10;
+                ++removed;
+            }
+        }
+        //exactly halfway: round to even
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0)
+            last_removed = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    }
+    else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100){
+            round_up = vr % 100 >= 50;
+            vr /= 100; vp /= 100; vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10){
+            round_up = vr % 10 >= 5;
+            vr /= 10; vp /= 10; vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    mantissa = output;
+    exponent = e10 + removed;
+}
+
+//the layout of "%.17g" with the shortest digits: plain notation for exponents in [-4, 17), scientific
+//otherwise, integers in plain notation are exact; writes at most 25 characters and returns the end. JSON has no inf or nan, they become null.
+static char *write_double(double value, char *dst){
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint64_t ieee_mantissa = bits & ((uint64_t(1) << 52) - 1);
+    const uint32_t ieee_exponent = static_cast<uint32_t>(bits >> 52) & 0x7FF;
+    if (ieee_exponent == 0x7FF){
+        memcpy(dst, "null", 4);
+        return dst + 4;
+    }
+    if (bits >> 63) *dst++ = '-';
+    if (ieee_exponent == 0 && ieee_mantissa == 0){
+        *dst++ = '0';
+        return dst;
+    }
+
+    uint64_t mantissa;
+    int32_t exponent;
+    shortest_decimal(ieee_mantissa, ieee_exponent, mantissa, exponent);
+    const int32_t length = static_cast<int32_t>(decimal_length(mantissa));
+    const int32_t point = length + exponent; //digits before the decimal point
+    if (point - 1 >= -4 && point - 1 < 17){
+        if (exponent == 0){
+            write_digits(mantissa, length, dst);
+            return dst + point;
+        }
+        if (exponent > 0){
+            //padding the digits with zeros could give another integer (above 2^53), which the parser
+            //keeps exactly: write the integer value of the double, it has `point` digits
+            write_digits(static_cast<uint64_t>(std::fabs(value)), point, dst);
+            return dst + point;
+        }
+        if (point > 0){
+            write_digits(mantissa, length, dst + 1);
+            memmove(dst, dst + 1, point);
+            dst[point] = '.';
+            return dst + length + 1;
+        }
+        dst[0] = '0';
+        dst[1] = '.';
+        memset(dst + 2, '0', -point);
+        write_digits(mantissa, length, dst + 2 - point);
+        return dst + 2 - point + length;
+    }
+
+    //d.ddde+XX, with at least two exponent digits
+    write_digits(mantissa, length, dst + 1);
+    dst[0] = dst[1];
+    if (length > 1){
+        dst[1] = '.';
+        dst += length + 1;
+    }
+    else
+        dst += 1;
+    int32_t e = point - 1;
+    *dst++ = 'e';
+    *dst++ = e < 0 ? '-' : '+';
+    uint32_t magnitude = e < 0 ? -e : e;
+    if (magnitude >= 100){
+        *dst++ = static_cast<char>('0' + magnitude / 100);
+        magnitude %= 100;
+    }
+    memcpy(dst, digit_pairs + 2 * magnitude, 2);
+    return dst + 2;
+}
+
+//Scanners for the parser hot loops: skip a whitespace run, or find the end of a plain string span
+//(the next '"', '\\' or control character, or also non-ASCII for the serializer). They look at 16/32 bytes at a time when the CPU allows it,
+//the implementation is picked once at startup, and LXJSON_NO_SIMD=1 forces the scalar one.
+static inline bool is_space(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool is_string_special(char c){
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+static const char *skip_space_scalar(const char *p, const char *end){
+    while (p < end && is_space(*p)) ++p;
+    return p;
+}
+
+static const char *scan_string_scalar(const char *p, const char *end){
+    while (p < end && !is_string_special(*p)) ++p;
+    return p;
+}
+
+//also stops on the bytes of non-ASCII characters, for the serializer
+static const char *scan_ascii_scalar(const char *p, const char *end){
+    while (p < end && !is_string_special(*p) && static_cast<unsigned char>(*p) < 0x80) ++p;
+    return p;
+}
+
+//the first byte of [p, end) that is not part of well-formed UTF-8, end when there is none.
+//ASCII is skipped a word at a time, the rest is decoded one character at a time.
+static const char *validate_utf8_scalar(const char *p, const char *end){
+    while (p < end){
+        uint64_t word;
+        if (end - p >= 8 && (memcpy(&word, p, 8), !(word & 0x8080808080808080ULL))){
+            p += 8;
+            continue;
+        }
+        if (static_cast<unsigned char>(*p) < 0x80){
+            ++p;
+            continue;
+        }
+        uint32_t code;
+        const char *next = decode_utf8(p, end, code);
+        if (!next) return p;
+        p = next;
+    }
+    return end;
+}
+
+#ifdef LXJSON_X86_SIMD
+static inline unsigned ctz(unsigned mask){
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+
+static const char *skip_space_sse2(const char *p, const char *end){
+    const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), cr = _mm_set1_epi8('\r'), lf = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, sp), _mm_cmpeq_epi8(x, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(x, cr), _mm_cmpeq_epi8(x, lf)));
+        unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFF;
+        if (mask) return p + ctz(mask);
+    }
+    return skip_space_scalar(p, end);
+}
+
+static const char *scan_string_sse2(const char *p, const char *end){
+    const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+    for (; end - p >= 16; p += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        //x <= 0x1F (unsigned) <=> min(x, 0x1F) == x
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(x, ctrl), x));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) return p + ctz(mask);
+    }
+    return scan_string_scalar(p, end);
+}
+
+static const char *scan_ascii_sse2(const char *p, const char *end){
+    const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), space = _mm_set1_epi8(0x20);
+    for (; end - p >= 16; p += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        //as signed bytes, x < 0x20 covers both the control characters and the bytes above 0x7F
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+                                       _mm_cmplt_epi8(x, space));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+        if (mask) return p + ctz(mask);
+    }
+    return scan_ascii_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *skip_space_avx2(const char *p, const char *end){
+    const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t'), cr = _mm256_set1_epi8('\r'), lf = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32){
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, sp), _mm256_cmpeq_epi8(x, tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(x, cr), _mm256_cmpeq_epi8(x, lf)));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(ws));
+        if (mask) return p + ctz(mask);
+    }
+    return skip_space_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *scan_string_avx2(const char *p, const char *end){
+    const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), ctrl = _mm256_set1_epi8(0x1F);
+    for (; end - p >= 32; p += 32){
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+                                          _mm256_cmpeq_epi8(_mm256_min_epu8(x, ctrl), x));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+        if (mask) return p + ctz(mask);
+    }
+    return scan_string_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *scan_ascii_avx2(const char *p, const char *end){
+    const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), space = _mm256_set1_epi8(0x20);
+    for (; end - p >= 32; p += 32){
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+                                          _mm256_cmpgt_epi8(space, x));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+        if (mask) return p + ctz(mask);
+    }
+    return scan_ascii_sse2(p, end);
+}
+
+//UTF-8 validation 32 bytes at a time, after Keiser and Lemire, "Validating UTF-8 in less than one
+//instruction per byte" (2021). Each byte is classified by three table lookups, on the high and low
+//nibbles of the byte before it and on its own high nibble; their AND is nonzero exactly for the pairs
+//that cannot follow each other. The bytes 2 or 3 after a 3 or 4 byte lead must be continuations.
+//The lookups need pshufb, so the SSE2 build falls back to the scalar validator.
+enum : uint8_t {
+    UTF8_TOO_SHORT = 1 << 0,  //11______ 0_______ or 11______ 11______
+    UTF8_TOO_LONG = 1 << 1,   //0_______ 10______
+    UTF8_OVERLONG_3 = 1 << 2, //11100000 100_____
+    UTF8_TOO_LARGE = 1 << 3,  //11110100 1001____ and above
+    UTF8_SURROGATE = 1 << 4,  //11101101 101_____
+    UTF8_OVERLONG_2 = 1 << 5, //1100000_ 10______
+    UTF8_TOO_LARGE_1000 = 1 << 6, //11110101 1000____ and above
+    UTF8_OVERLONG_4 = 1 << 6, //11110000 1000____
+    UTF8_TWO_CONTS = 1 << 7,  //10______ 10______
+    UTF8_CARRY = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS
+};
+
+__attribute__((target("avx2")))
+static inline __m256i lookup_nibble(__m256i table, __m256i x){
+    return _mm256_shuffle_epi8(table, _mm256_and_si256(x, _mm256_set1_epi8(0x0F)));
+}
+
+//the bits of the invalid pairs in input, prev the block before it
+__attribute__((target("avx2")))
+static inline __m256i utf8_errors(__m256i input, __m256i prev){
+    const __m256i byte_1_high = _mm256_setr_epi8(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT, UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2, UTF8_TOO_SHORT, UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+    const uint8_t large = UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000;
+    const __m256i byte_1_low = _mm256_setr_epi8(
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, UTF8_CARRY | UTF8_OVERLONG_2, UTF8_CARRY, UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE, large, large, large, large, large, large, large, large, large | UTF8_SURROGATE, large, large,
+        UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, UTF8_CARRY | UTF8_OVERLONG_2, UTF8_CARRY, UTF8_CARRY,
+        UTF8_CARRY | UTF8_TOO_LARGE, large, large, large, large, large, large, large, large, large | UTF8_SURROGATE, large, large);
+    const uint8_t cont = UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS;
+    const __m256i byte_2_high = _mm256_setr_epi8(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        cont | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, cont | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        cont | UTF8_SURROGATE | UTF8_TOO_LARGE, cont | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        cont | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, cont | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,
+        cont | UTF8_SURROGATE | UTF8_TOO_LARGE, cont | UTF8_SURROGATE | UTF8_TOO_LARGE,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    //the bytes 1, 2 and 3 before each byte of input
+    __m256i carried = _mm256_permute2x128_si256(prev, input, 0x21);
+    __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    __m256i prev2 = _mm256_alignr_epi8(input, carried, 14);
+    __m256i prev3 = _mm256_alignr_epi8(input, carried, 13);
+    __m256i special = _mm256_and_si256(_mm256_and_si256(lookup_nibble(byte_1_high, _mm256_srli_epi16(prev1, 4)),
+                                                        lookup_nibble(byte_1_low, prev1)),
+                                       lookup_nibble(byte_2_high, _mm256_srli_epi16(input, 4)));
+    //only 111_____ two bytes before and 1111____ three bytes before keep their high bit
+    __m256i must_continue = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80))),
+                                            _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80))));
+    return _mm256_xor_si256(_mm256_and_si256(must_continue, _mm256_set1_epi8(static_cast<char>(0x80))), special);
+}
+
+//false when [p, end) is not well-formed. Its own function, for the vzeroupper on the way out.
+__attribute__((target("avx2")))
+static bool validate_utf8_blocks(const char *p, const char *end){
+    //a lead byte in the last 3 bytes of a block whose sequence cannot end within it
+    const __m256i max_complete = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                  static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+    __m256i prev = _mm256_setzero_si256(), incomplete = _mm256_setzero_si256(), error = _mm256_setzero_si256();
+    for (size_t left = static_cast<size_t>(end - p); left; ){
+        __m256i input;
+        if (left >= 32){
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            p += 32;
+            left -= 32;
+        }
+        else {
+            char tail[32] = {}; //the padding is ASCII, a sequence cut short by the end is an error
+            memcpy(tail, p, left);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tail));
+            left = 0;
+        }
+        if (_mm256_movemask_epi8(input)){
+            error = _mm256_or_si256(error, utf8_errors(input, prev));
+            incomplete = _mm256_subs_epu8(input, max_complete);
+        }
+        else { //ASCII, only an unfinished sequence before it can be wrong
+            error = _mm256_or_si256(error, incomplete);
+            incomplete = _mm256_setzero_si256();
+        }
+        prev = input;
+    }
+    error = _mm256_or_si256(error, incomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+static const char *validate_utf8_avx2(const char *p, const char *end){
+    if (end - p < 32) return validate_utf8_scalar(p, end); //the usual short string
+    if (validate_utf8_blocks(p, end)) return end;
+    return validate_utf8_scalar(p, end); //to find where
+}
+#endif
+
+struct Scanners{
+    const char *(*skip_space)(const char *, const char *);
+    const char *(*scan_string)(const char *, const char *);
+    const char *(*scan_ascii)(const char *, const char *);
+    const char *(*validate_utf8)(const char *, const char *);
+};
+
+static Scanners select_scanners(){
+    const char *no_simd = std::getenv("LXJSON_NO_SIMD");
+    if (no_simd && *no_simd && *no_simd != '0')
+        return {skip_space_scalar, scan_string_scalar, scan_ascii_scalar, validate_utf8_scalar};
+#ifdef LXJSON_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return {skip_space_avx2, scan_string_avx2, scan_ascii_avx2, validate_utf8_avx2};
+    return {skip_space_sse2, scan_string_sse2, scan_ascii_sse2, validate_utf8_scalar};
+#else
+    return {skip_space_scalar, scan_string_scalar, scan_ascii_scalar, validate_utf8_scalar};
+#endif
+}
+
+static const Scanners scanners = select_scanners();
+
+static const char *scan_plain(const char *p, const char *end){
+    return scanners.scan_string(p, end);
+}
+static const char *scan_plain_ascii(const char *p, const char *end){
+    return scanners.scan_ascii(p, end);
+}
+
+static const char *describe(ParseStatus::Error error){
+    using Error = ParseStatus::Error;
+    switch (error){
+        case Error::NONE: return "no error";
+        case Error::UNEXPECTED_END: return "unexpected end of input";
+        case Error::INVALID_VALUE: return "invalid value";
+        case Error::INVALID_LITERAL: return "invalid literal, expected null, true or false";
+        case Error::INVALID_NUMBER: return "invalid number";
+        case Error::NUMBER_OUT_OF_RANGE: return "number out of range";
+        case Error::UNTERMINATED_STRING: return "missing closing quotation mark";
+        case Error::INVALID_STRING_CHARACTER: return "invalid character in string";
+        case Error::INVALID_ESCAPE: return "invalid escape in string";
+        case Error::INVALID_UNICODE_ESCAPE: return "invalid \\u escape";
+        case Error::EXPECTED_COMMA_OR_BRACKET: return "expected ',' or ']' in array";
+        case Error::EXPECTED_COMMA_OR_BRACE: return "expected ',' or '}' in object";
+        case Error::EXPECTED_KEY: return "expected a key in object";
+        case Error::EXPECTED_COLON: return "expected ':' in object";
+        case Error::TRAILING_CHARACTERS: return "unexpected characters after the value";
+        case Error::TOO_DEEP: return "nesting too deep";
+        case Error::INVALID_UTF8: return "invalid UTF-8 in string";
+    }
+    return "unknown error";
+}
+
+string ParseStatus::message() const{
+    return string(describe(error)) + " at line " + std::to_string(line) + ", column " + std::to_string(column);
+}
+
+//A container being built by jParser. The open ones are kept on a stack, innermost last, so that
+//nothing is left on the call stack. The elements of an array and the members of a FlatObject wait on
+//a stack of their own from `base` on, so that the container is built at its final size; a std::map
+//object is filled in its node.
+struct ParseFrame{
+    Json node;    //std::map objects only
+    size_t base;
+    Json *member; //std::map: where the value of the current member goes, nullptr for a duplicate key
+    bool object;
+};
+
+//what a parse needs besides its result, handed from one parse to the next: by each thread for
+//Json::parse, by a Json::Parser for its own parses
+struct ParseBuffers{
+    vector<ParseFrame> stack;
+    vector<Json> values;
+#ifdef LXJSON_FLAT_OBJECT
+    vector<Json::object::value_type> entries;
+    std::unique_ptr<KeyTable> keys; //Json::Parser only, shared by its documents
+#endif
+    string text; //a string with escapes, unescaped
+};
+
+//Errors are not thrown: the first one is recorded with its position, and every parse function
+//returns as soon as the one it called has failed, so that a malformed input is given up cheaply.
+class jParser final {
+public:
+    using Error = ParseStatus::Error;
+
+    jParser(const string& s, Arena *arena = nullptr)
+        : text_(s.c_str()), start_(s.c_str()), pos_(s.c_str()), end_(s.c_str() + s.size()), arena_(arena){}
+    //[begin, end) must be followed by a '\0', like the buffer of a std::string. With `views`, the strings
+    //without escapes point into it, so it must live as long as the arena, which is then required.
+    jParser(const char *begin, const char *end, Arena *arena = nullptr, bool views = false)
+        : text_(begin), start_(begin), pos_(begin), end_(end), arena_(arena), views_(views){}
+    jParser(const jParser&) = delete;
+    jParser& operator=(const jParser&) = delete;
+    ~jParser(){
+        if (stack_.capacity()) releaseBuffers(); //only a parser that has opened a container holds them
+    }
+    Json parse(){
+        if (*start_ == '[' || *start_ == '{') return source_ ? parseLazy() : parseContainer();
+        return parseScalar();
+    }
+    //after the value: nothing but whitespace up to the end
+    void expectEnd(){
+        if (failed()) return;
+        skipSpace();
+        if (pos_ != end_) fail(Error::TRAILING_CHARACTERS, pos_);
+    }
+
+    bool failed() const{
+        return error_ != Error::NONE;
+    }
+    Json fail(Error error, const char *at){
+        if (!failed()){
+            error_ = error;
+            error_at_ = at;
+        }
+        return Json(nullptr);
+    }
+    //the error and its position, from the start of the text; the lines are only counted here
+    ParseStatus status() const{
+        ParseStatus status;
+        if (!failed()) return status;
+        status.error = error_;
+        status.offset = static_cast<size_t>(error_at_ - text_);
+        status.line = 1;
+        const char *line_begin = text_;
+        for (const char *p = text_; (p = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(error_at_ - p)))); ){
+            ++status.line;
+            line_begin = ++p;
+        }
+        status.column = static_cast<size_t>(error_at_ - line_begin) + 1;
+        return status;
+    }
+    //for the engines that report their own errors by throwing
+    void check() const{
+        if (failed()) throw std::runtime_error(describe(error_));
+    }
+    void skipSpace(){
+        //most gaps are empty or a single space, don't pay for a call on those
+        if (is_space(*pos_) && is_space(*++pos_))
+            pos_ = scanners.skip_space(pos_, end_);
+        start_ = pos_;
+    }
+
+    char get_pos(){
+        return *pos_;
+    }
+
+    //for the engines that locate the values themselves and only need them decoded
+    void seek(const char *p){
+        start_ = pos_ = p;
+    }
+    const char *position() const{
+        return pos_;
+    }
+private:
+    using Frame = ParseFrame;
+
+    const char* text_; //where the offsets are counted from
+    const char* start_;
+    const char* pos_;
+    const char* end_;
+    Arena *arena_; //where the nodes go, nullptr for the heap
+    bool views_ = false;
+    std::shared_ptr<const LazySource> source_; //set when the nested containers are left lazy
+    size_t next_container_ = 0;               //index of the next one in source_->extents
+    vector<LazySource::Extent> *extents_ = nullptr; //where validate() records the containers
+    KeyTable *keys_ = nullptr; //where the object keys are interned, a table of the parser's own by default
+    std::unique_ptr<KeyTable> own_keys_;
+    ParseBuffers *buffers_ = nullptr; //where the buffers below are taken from, the thread's by default
+    string text_buf_;
+    vector<Frame> stack_;
+    vector<Json> values_;
+#ifdef LXJSON_FLAT_OBJECT
+    vector<Json::object::value_type> entries_;
+#endif
+    size_t max_depth_ = ParseOptions().max_depth;
+    bool validate_utf8_ = false;
+    size_t depth_ = 0; //of the walks
+    Error error_ = Error::NONE;
+    const char *error_at_ = nullptr;
+
+    //the raw bytes of a string, between its quotes and escapes, with ParseOptions::validate_utf8
+    bool checkUtf8(const char *begin, const char *end){
+        if (!validate_utf8_) return true;
+        const char *invalid = scanners.validate_utf8(begin, end);
+        if (invalid == end) return true;
+        fail(Error::INVALID_UTF8, invalid);
+        return false;
+    }
+
+    //an end of the text where something else was expected is reported as such
+    Json unexpected(Error error){
+        return fail(pos_ == end_ ? Error::UNEXPECTED_END : error, pos_);
+    }
+
+    template<size_t N>
+    Json parseLiteral(const char (&expected)[N], Json res){
+        if (strncmp(pos_, expected, N - 1))
+            return fail(Error::INVALID_LITERAL, pos_);
+        pos_ += N - 1;
+        return res;
+    }
+
+    //exactly 4 hex digits, sscanf would also take fewer digits, spaces or a sign
+    static bool read_hex4(const char *p, uint16_t &value){
+        value = 0;
+        for (int i = 0; i < 4; ++i){
+            char c = p[i];
+            int digit;
+            if (in_range(c, '0', '9')) digit = c - '0';
+            else if (in_range(c, 'a', 'f')) digit = c - 'a' + 10;
+            else if (in_range(c, 'A', 'F')) digit = c - 'A' + 10;
+            else return false;
+            value = static_cast<uint16_t>(value << 4 | digit);
+        }
+        return true;
+    }
+
+    //the code unit of the \uXXXX escape at pos_, false when there is none
+    bool readEscape(uint32_t &unit){
+        uint16_t value;
+        if (strncmp(pos_, "\\u", 2)){
+            fail(Error::INVALID_UNICODE_ESCAPE, pos_);
+            return false;
+        }
+        if (!read_hex4(pos_ + 2, value)){
+            fail(Error::INVALID_UNICODE_ESCAPE, pos_);
+            return false;
+        }
+        pos_ += 6;
+        unit = value;
+        return true;
+    }
+
+    //append the character of the \uXXXX escape at pos_, false when it is not a valid one. A character
+    //above U+FFFF is a high surrogate escape followed by a low one, a surrogate alone is an error.
+    bool parse4hex(string &out){
+        uint32_t code, low;
+        if (!readEscape(code)) return false;
+        if (code >= 0xD800 && code <= 0xDFFF){
+            if (code >= 0xDC00){
+                fail(Error::INVALID_UNICODE_ESCAPE, pos_ - 6);
+                return false;
+            }
+            if (!readEscape(low)) return false;
+            if (low < 0xDC00 || low > 0xDFFF){
+                fail(Error::INVALID_UNICODE_ESCAPE, pos_ - 6);
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        append_utf8(code, out);
+        return true;
+    }
+
+    //false on an invalid escape, c is the character after the backslash at pos_ - 1
+    bool encode_utf8(char c, string& out){
+        switch(c){
+            case '\"' : case '\\': case '/':
+                out.push_back(c);
+                break;
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
                 out.push_back('\n');
                 break;
             case 'r':
@@ -462,147 +3191,2433 @@ private:
                 break;
             case 'u':
                 --pos_;
-                out += parse4hex();
+                if (!parse4hex(out)) return false;
                 --pos_;
                 break;
-            default:;
+            default:
+                fail(Error::INVALID_ESCAPE, pos_ - 1);
+                return false;
         }
+        return true;
     }
 
 
 
-    Json parseString(){
-        string out;
+public:
+    //parse the raw string and append it to out, the caller decides whether it becomes a value or a key
+    void parseRawString(string &out){
+        const char *open = pos_++; //skip '"'
         while(true){
-            char c = *(++pos_);//get the current char
-            switch(c){
+            //copy the plain span in one go, then deal with the byte that stopped it
+            const char *span_end = scanners.scan_string(pos_, end_);
+            if (!checkUtf8(pos_, span_end)) return;
+            out.append(pos_, span_end);
+            pos_ = span_end;
+            switch(*pos_){
                 case '\"':
                     start_ = ++pos_;
-                    return Json(out);
-                case '\0':
-                    throw std::runtime_error("MISSING QUOTATION MARK!");
+                    return;
                 case '\\':
-                    encode_utf8(*++pos_, out);
+                    if (++pos_ == end_){
+                        fail(Error::UNTERMINATED_STRING, open);
+                        return;
+                    }
+                    if (!encode_utf8(*pos_, out)) return;
+                    ++pos_;
                     break;
                 default:
-                    if (static_cast<unsigned char>(c) < 0x20)
-                        throw std::runtime_error("INVALID STRING CHARACTER!");
-                    out.push_back(c);
+                    fail(pos_ == end_ ? Error::UNTERMINATED_STRING : Error::INVALID_STRING_CHARACTER, pos_ == end_ ? open : pos_);
+                    return;
+            }
+        }
+    }
+
+    Json parseString(){
+        if (views_){
+            const char *begin = pos_ + 1;
+            const char *span_end = scanners.scan_string(begin, end_);
+            if (*span_end == '"'){
+                if (!checkUtf8(begin, span_end)) return Json(nullptr);
+                start_ = pos_ = span_end + 1;
+                return Json::make_node<ViewNode>(Json::Kind::K_STRING_VIEW, arena_, begin, static_cast<size_t>(span_end - begin));
             }
         }
-        return Json(out);
+        StringView text = readString(); //copied once, at its final size
+        if (failed()) return Json(nullptr);
+        return Json::make_node<StringNode>(Json::Kind::K_STRING, arena_, text.data, text.size);
     }
 
     Json parseNum() {
-        if (*pos_ == '-') ++pos_;
+        bool negative = *pos_ == '-';
+        if (negative) ++pos_;
+
+        //the digits are accumulated while they are checked, up to 19 significant ones
+        uint64_t mantissa = 0;
+        int significant = 0;
+        int64_t exponent = 0;
+        auto digit = [&](char c){
+            if (significant || c != '0'){
+                if (++significant <= 19)
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            }
+        };
 
         //Integer part
         if (*pos_ == '0') {
             ++pos_;
             if (in_range(*pos_, '0', '9'))
-                throw std::runtime_error("INVALID! leading 0s not permitted in numbers");
+                return fail(Error::INVALID_NUMBER, pos_); //leading 0s are not permitted
         }
         else {
-            if (!in_range(*pos_, '1', '9')) {throw std::runtime_error("INVALID value");}
-            while (in_range(*(++pos_), '0', '9'));
+            if (!in_range(*pos_, '1', '9')) return negative ? fail(Error::INVALID_NUMBER, pos_) : unexpected(Error::INVALID_VALUE);
+            do digit(*pos_); while (in_range(*(++pos_), '0', '9'));
         }
+        const char *int_end = pos_;
+        bool is_integer = true;
 
         //demical part
         if (*pos_ == '.') {
-            if (!in_range(*++pos_, '0', '9')) throw std::runtime_error("INVALID FLOAT");
-            while (in_range(*(++pos_), '0', '9'));
+            is_integer = false;
+            if (!in_range(*++pos_, '0', '9')) return fail(Error::INVALID_NUMBER, pos_);
+            const char *frac_begin = pos_;
+            do digit(*pos_); while (in_range(*(++pos_), '0', '9'));
+            exponent -= pos_ - frac_begin;
         }
 
         //Exponent part
         if (*pos_=='e'||*pos_=='E') {
+            is_integer = false;
             pos_++;
+            bool negative_exp = *pos_ == '-';
             if (*pos_=='-'||*pos_=='+') pos_++;
-            if (!in_range(*pos_, '0', '9')) throw std::runtime_error("INVALID EXPONENT");
-            while (in_range(*(++pos_), '0', '9'));
+            if (!in_range(*pos_, '0', '9')) return fail(Error::INVALID_NUMBER, pos_);
+            int64_t exp_value = 0;
+            do {
+                if (exp_value < 100000) exp_value = exp_value * 10 + (*pos_ - '0');
+            } while (in_range(*(++pos_), '0', '9'));
+            exponent += negative_exp ? -exp_value : exp_value;
         }
 
-        double val = std::strtod(start_, nullptr);
-        if (std::fabs(val) == std::numeric_limits<double>::max())
-            throw std::runtime_error("DOUBLE OVERFLOW");
+        const char *begin = start_;
         start_ = pos_;
+        if (is_integer && !(negative && mantissa == 0)) {
+            if (significant == 20) {
+                //may still fit in an uint64_t
+                uint64_t value = mantissa;
+                const char *last = int_end - 1;
+                if (value <= (std::numeric_limits<uint64_t>::max() - (*last - '0')) / 10) {
+                    value = value * 10 + static_cast<uint64_t>(*last - '0');
+                    if (!negative) return Json(value);
+                }
+            }
+            else if (significant < 20) {
+                if (!negative) return Json(mantissa);
+                if (mantissa <= static_cast<uint64_t>(INT64_MAX) + 1)
+                    return Json(static_cast<int64_t>(0 - mantissa));
+            }
+        }
+
+        double val;
+        if (significant > 19 || !decimal_to_double(mantissa, exponent, negative, val))
+            val = strtod_c_locale(begin, pos_);
+        if (std::isinf(val))
+            return fail(Error::NUMBER_OUT_OF_RANGE, begin);
         return Json(val);
     }
 
-    Json parseArray(){
-        lxjson::Json::array data;
-        pos_++; //skip '['
+private:
+    //a value that is not a container
+    Json parseScalar(){
+        switch(*start_){
+            case 'n':
+                return parseLiteral("null", Json(nullptr));
+            case 't':
+                return parseLiteral("true", Json(true));
+            case 'f':
+                return parseLiteral("false", Json(false));
+            case '\"':
+                return parseString();
+            case '\0':
+                return unexpected(Error::INVALID_VALUE);
+            default:
+                return parseNum();
+        }
+    }
+
+    //opens the container at the current position, pushed onto stack_ up to its first element; false
+    //when it is empty instead, and then complete in `value`, or on an error
+    bool openContainer(Json &value){
+        if (depth_ + stack_.size() >= max_depth_){ //a match of select() is built inside the walks
+            fail(Error::TOO_DEEP, pos_);
+            return false;
+        }
+        bool object = *pos_ == '{';
+        pos_++; //skip '[' or '{'
         skipSpace();
-        if (*pos_ == ']') {
+        if (*pos_ == (object ? '}' : ']')) {
             start_ = ++pos_;
-            return Json(data);
+            if (object) value = Json::make_node<ObjectNode>(Json::Kind::K_OBJECT, arena_, Json::object());
+            else value = Json::make_node<ArrayNode>(Json::Kind::K_ARRAY, arena_, Json::array());
+            return false;
         }
-        while(true) {
-            skipSpace();
-            data.push_back(this->parse());
-            skipSpace();
-
-            if (*pos_ == ']') {
-                start_ = ++pos_;
-                return Json(data);
-            }
-            if (*pos_ != ',') throw std::runtime_error("expected ',' in list, got " + *pos_);
-            pos_++; 
+        if (!stack_.capacity()) takeBuffers();
+        if (!object){
+            stack_.push_back(Frame{Json(), values_.size(), nullptr, false});
+            return true;
         }
-        return Json(nullptr);
+#ifdef LXJSON_FLAT_OBJECT
+        stack_.push_back(Frame{Json(), entries_.size(), nullptr, true});
+#else
+        stack_.push_back(Frame{Json::make_node<ObjectNode>(Json::Kind::K_OBJECT, arena_, Json::object()), 0, nullptr, true});
+#endif
+        return parseMemberKey();
     }
 
-    Json parseObject(){
-        lxjson::Json::object data;
-        pos_++;
+    //the key of the next member and its ':', up to its value
+    bool parseMemberKey(){
+        if (*pos_!='"') {
+            unexpected(Error::EXPECTED_KEY);
+            return false;
+        }
+#ifdef LXJSON_FLAT_OBJECT
+        entries_.emplace_back(parseKey(), Json());
+        if (failed()) return false;
+#else
+        StringView key = readString();
+        if (failed()) return false;
+        auto inserted = members(stack_.back()).emplace(string(key.data, key.size), Json()); //the first of duplicate keys is kept
+        stack_.back().member = inserted.second ? &inserted.first->second : nullptr;
+#endif
         skipSpace();
-        if (*pos_ == '}') {
-            start_ = ++pos_;
-            return Json(data);
+        if (*pos_ != ':') {
+            unexpected(Error::EXPECTED_COLON);
+            return false;
         }
-        while(true) {
-            skipSpace();
-            if (*pos_!='"') throw std::runtime_error("expected '\"' in object, got " + *pos_);
-            Json key_json = parseString();
-            if (!key_json.is_string()) return Json();
-            string key = key_json.string_value();
+        ++pos_;
+        skipSpace();
+        return true;
+    }
 
-            skipSpace();
-            if (*pos_++ != ':') throw std::runtime_error("expected ':' in object, got " + *pos_);
-            skipSpace();
+    //The buffers are kept from one parse to the next, by each thread or by a Json::Parser, most parses
+    //then need no allocation for them: a parser takes them when it opens its first container, and gives
+    //them back empty when it is done. A parser created while another one holds them starts its own.
+    static ParseBuffers &threadBuffers(){
+        static thread_local ParseBuffers cached;
+        return cached;
+    }
+    void takeBuffers(){
+        ParseBuffers &cached = buffers_ ? *buffers_ : threadBuffers();
+        stack_.swap(cached.stack);
+        if (!stack_.capacity()) stack_.reserve(16);
+        values_.swap(cached.values);
+        if (!values_.capacity()) values_.reserve(16);
+#ifdef LXJSON_FLAT_OBJECT
+        entries_.swap(cached.entries);
+        if (!entries_.capacity()) entries_.reserve(16);
+#endif
+        text_buf_.swap(cached.text);
+    }
+    void releaseBuffers(){
+        abandon();
+        ParseBuffers &cached = buffers_ ? *buffers_ : threadBuffers();
+        if (cached.stack.capacity() < stack_.capacity()) cached.stack.swap(stack_);
+        if (cached.values.capacity() < values_.capacity()) cached.values.swap(values_);
+#ifdef LXJSON_FLAT_OBJECT
+        if (cached.entries.capacity() < entries_.capacity()) cached.entries.swap(entries_);
+#endif
+        if (cached.text.capacity() < text_buf_.capacity()) cached.text.swap(text_buf_);
+    }
 
-            data.insert({std::move(key), parse()}); //insert can tell whether the element is inserted into the map. 
-            skipSpace();
+#ifndef LXJSON_FLAT_OBJECT
+    static Json::object &members(Frame &frame){
+        return static_cast<ObjectNode *>(frame.node.m_node)->m_value;
+    }
+#endif
 
-            if (*pos_ == ',') ++pos_;
-            else if (*pos_ == '}') {
-                start_ = ++pos_;
-                break;
-            }
-            else throw std::runtime_error("miss curly bracket");
+    //the innermost container, complete
+    Json closeContainer(){
+        Frame &frame = stack_.back();
+        start_ = ++pos_;
+        if (!frame.object){
+            Json::array data(std::make_move_iterator(values_.begin() + frame.base), std::make_move_iterator(values_.end()));
+            values_.erase(values_.begin() + frame.base, values_.end());
+            stack_.pop_back();
+            return Json::make_node<ArrayNode>(Json::Kind::K_ARRAY, arena_, std::move(data));
         }
-        return Json(data);
+#ifdef LXJSON_FLAT_OBJECT
+        lxjson::Json::object data;
+        data.reserve(entries_.size() - frame.base);
+        for (auto it = entries_.begin() + frame.base; it != entries_.end(); ++it)
+            data.emplace(std::move(it->first), std::move(it->second)); //the first of duplicate keys is kept
+        entries_.erase(entries_.begin() + frame.base, entries_.end());
+        stack_.pop_back();
+        return Json::make_node<ObjectNode>(Json::Kind::K_OBJECT, arena_, std::move(data));
+#else
+        Json value = std::move(frame.node);
+        stack_.pop_back();
+        return value;
+#endif
     }
 
+    //where the scan of a container stops
+    enum class Step{
+        MORE,   //at its next element
+        NESTED, //at an element that is a container
+        CLOSED, //at its closing bracket
+        FAILED
+    };
 
-};
+    //after an element of the innermost container
+    Step next(Frame &top){
+        skipSpace();
+        if (*pos_ == ','){
+            ++pos_;
+            skipSpace();
+            return !top.object || parseMemberKey() ? Step::MORE : Step::FAILED;
+        }
+        if (*pos_ == (top.object ? '}' : ']')) return Step::CLOSED;
+        unexpected(top.object ? Error::EXPECTED_COMMA_OR_BRACE : Error::EXPECTED_COMMA_OR_BRACKET);
+        return Step::FAILED;
+    }
 
+    //the scalars of the innermost container, in a loop of its own, up to its end or a nested container
+    Step scanElements(Frame &top){
+        while (true){
+            if (*pos_ == '[' || *pos_ == '{') return Step::NESTED;
+            values_.push_back(parseScalar());
+            if (failed()) return Step::FAILED;
+            Step step = next(top);
+            if (step != Step::MORE) return step;
+        }
+    }
+    Step scanMembers(Frame &top){
+        while (true){
+            if (*pos_ == '[' || *pos_ == '{') return Step::NESTED;
+            addMember(top, parseScalar());
+            if (failed()) return Step::FAILED;
+            Step step = next(top);
+            if (step != Step::MORE) return step;
+        }
+    }
+    void addMember(Frame &top, Json &&value){
+#ifdef LXJSON_FLAT_OBJECT
+        (void)top;
+        entries_.back().second = std::move(value); //the member of the innermost object is the last
+#else
+        if (top.member) *top.member = std::move(value);
+#endif
+    }
 
+    //a complete element of the innermost container
+    Step attach(Json &&value){
+        Frame &top = stack_.back();
+        if (top.object) addMember(top, std::move(value));
+        else values_.push_back(std::move(value));
+        return next(top);
+    }
 
-Json Json::parse(const string &in, string &err) noexcept{
-    try {
-        jParser p(in);
-        p.skipSpace();
-        Json result = p.parse();
-        p.skipSpace();
-        if (p.get_pos()) throw std::runtime_error("unexpected trailing " + p.get_pos());
+    //the array or object at the current position, with a loop rather than a recursion per level
+    Json parseContainer(){
+        Json value;
+        while (true){
+            //at a container to open, then at the next element of the innermost one
+            bool opened = false;
+            if (source_ && !stack_.empty()) value = parseLazy(); //a nested one is left to its own parse
+            else opened = openContainer(value);
+            if (failed()) return abandon();
+            if (stack_.empty()) return value;
+            Step step = opened ? Step::MORE : attach(std::move(value));
+            while (true){
+                //complete the containers that end here
+                while (step == Step::CLOSED){
+                    value = closeContainer();
+                    if (stack_.empty()) return value;
+                    step = attach(std::move(value));
+                }
+                if (step != Step::MORE) break;
+                Frame &top = stack_.back();
+                step = top.object ? scanMembers(top) : scanElements(top);
+            }
+            if (step == Step::FAILED) return abandon();
+        }
+    }
+
+    //drop what the failed parse has collected
+    Json abandon(){
+        stack_.clear();
+        values_.clear();
+#ifdef LXJSON_FLAT_OBJECT
+        entries_.clear();
+#endif
+        return Json(nullptr);
+    }
+
+#ifdef LXJSON_FLAT_OBJECT
+    //keys without escapes are interned straight from the input
+    JsonKey parseKey(){
+        if (!keys_){
+            own_keys_.reset(new KeyTable);
+            keys_ = own_keys_.get();
+        }
+        const char *begin = pos_ + 1;
+        const char *span_end = scanners.scan_string(begin, end_);
+        if (*span_end == '"'){
+            if (!checkUtf8(begin, span_end)) return JsonKey();
+            start_ = pos_ = span_end + 1;
+            return keys_->intern(begin, static_cast<size_t>(span_end - begin));
+        }
+        text_buf_.clear();
+        parseRawString(text_buf_);
+        return keys_->intern(text_buf_);
+    }
+#endif
+
+    //Lazy documents
+    //the nested container is only skipped, its extent was recorded when the document was validated
+    Json parseLazy(){
+        size_t index = next_container_;
+        const LazySource::Extent &extent = source_->extents[index];
+        next_container_ = extent.next;
+        Json::Kind kind = *pos_ == '[' ? Json::Kind::K_LAZY_ARRAY : Json::Kind::K_LAZY_OBJECT;
+        Json node = Json::make_node<LazyNode>(kind, arena_, source_, pos_, index);
+        start_ = pos_ = extent.end;
+        return node;
+    }
+
+    //reserve the container's extent on entry, so that the extents are in opening order
+    size_t openExtent(){
+        if (!extents_) return 0;
+        extents_->push_back(LazySource::Extent{nullptr, 0});
+        return extents_->size() - 1;
+    }
+    void closeExtent(size_t index){
+        if (extents_) (*extents_)[index] = LazySource::Extent{pos_, extents_->size()};
+    }
+
+    //the string at the current position, only copied when it has escapes
+    StringView readString(){
+        const char *begin = pos_ + 1;
+        const char *span_end = scanners.scan_string(begin, end_);
+        if (*span_end == '"'){
+            if (!checkUtf8(begin, span_end)) return StringView{begin, 0};
+            start_ = pos_ = span_end + 1;
+            return StringView{begin, static_cast<size_t>(span_end - begin)};
+        }
+        text_buf_.clear();
+        parseRawString(text_buf_);
+        return StringView{text_buf_.data(), text_buf_.size()};
+    }
+
+    //the walks recurse, the depth limit bounds their stack use. A failed parse is over, the depth
+    //is only given back on success.
+    bool enterWalk(){
+        if (depth_ >= max_depth_){
+            fail(Error::TOO_DEEP, pos_);
+            return false;
+        }
+        ++depth_;
+        return true;
+    }
+
+    //the grammar of parseContainer for the passes that build nothing: element(i) and member(key)
+    //consume the value at the current position. walkArray returns the element count, both stop at
+    //the first error.
+    template<typename F>
+    size_t walkArray(F element){
+        if (!enterWalk()) return 0;
+        size_t extent = openExtent();
+        size_t count = 0;
+        pos_++; //skip '['
+        skipSpace();
+        if (*pos_ != ']') {
+            while(true) {
+                skipSpace();
+                element(count++);
+                if (failed()) return count;
+                skipSpace();
+                if (*pos_ == ']') break;
+                if (*pos_ != ',') {
+                    unexpected(Error::EXPECTED_COMMA_OR_BRACKET);
+                    return count;
+                }
+                pos_++;
+            }
+        }
+        start_ = ++pos_;
+        closeExtent(extent);
+        --depth_;
+        return count;
+    }
+
+    template<typename F>
+    void walkObject(F member){
+        if (!enterWalk()) return;
+        size_t extent = openExtent();
+        pos_++;
+        skipSpace();
+        if (*pos_ != '}') {
+            while(true) {
+                skipSpace();
+                if (*pos_!='"') {
+                    unexpected(Error::EXPECTED_KEY);
+                    return;
+                }
+                StringView key = readString();
+                if (failed()) return;
+                skipSpace();
+                if (*pos_ != ':') {
+                    unexpected(Error::EXPECTED_COLON);
+                    return;
+                }
+                ++pos_;
+                skipSpace();
+                member(key);
+                if (failed()) return;
+                skipSpace();
+                if (*pos_ == ',') ++pos_;
+                else if (*pos_ == '}') break;
+                else {
+                    unexpected(Error::EXPECTED_COMMA_OR_BRACE);
+                    return;
+                }
+            }
+        }
+        start_ = ++pos_;
+        closeExtent(extent);
+        --depth_;
+    }
+
+public:
+    void intern_keys(KeyTable *keys){
+        keys_ = keys;
+    }
+
+    //take the buffers from `buffers` rather than from the thread's
+    void use_buffers(ParseBuffers &buffers){
+        buffers_ = &buffers;
+    }
+
+    //leave the nested containers lazy, pointing into `source`, which holds the text being parsed;
+    //`first` is the index of the first container to be met
+    void lazy(std::shared_ptr<const LazySource> source, size_t first){
+        source_ = std::move(source);
+        next_container_ = first;
+    }
+
+    //have validate() record the extents of the containers
+    void record_extents(vector<LazySource::Extent> *extents){
+        extents_ = extents;
+    }
+
+    //build the container at the current position, one level deep
+    Json parseLevel(){
+        return parseContainer();
+    }
+
+    //containers nested deeper than this are an error, for parse() and the passes that build nothing alike
+    void max_depth(size_t depth){
+        max_depth_ = depth;
+    }
+
+    //check the bytes of the strings, see ParseOptions::validate_utf8
+    void validate_utf8(bool on){
+        validate_utf8_ = on;
+    }
+
+    //check the value at the current position without building it, with the errors of parse()
+    void validate(){
+        switch(*start_){
+            case 'n':
+                parseLiteral("null", Json(nullptr));
+                break;
+            case 't':
+                parseLiteral("true", Json(true));
+                break;
+            case 'f':
+                parseLiteral("false", Json(false));
+                break;
+            case '\"':
+                readString();
+                break;
+            case '[':
+                walkArray([this](size_t){validate();});
+                break;
+            case '{':
+                walkObject([this](StringView){validate();});
+                break;
+            case '\0':
+                unexpected(Error::INVALID_VALUE);
+                break;
+            default:
+                parseNum();
+        }
+    }
+
+    //evaluate the steps of `path` from `step` on the value at the current position:
+    //the matches are built into out, everything else is only validated
+    void select(const JsonPath &path, size_t step, vector<Json> &out){
+        if (step == path.m_steps.size()){
+            out.push_back(parse());
+            return;
+        }
+        using Kind = JsonPath::Step::Kind;
+        const JsonPath::Step &s = path.m_steps[step];
+        if (*start_ == '{' && s.applies_to_object()){
+            walkObject([&](StringView key){
+                if (s.kind == Kind::WILDCARD || (key.size == s.name.size() && !memcmp(key.data, s.name.data(), key.size)))
+                    select(path, step + 1, out);
+                else
+                    validate();
+            });
+        }
+        else if (*start_ == '['){
+            size_t length = SIZE_MAX; //the bounds are not relative to the end, no need to know it
+            if (s.needs_length()){
+                const char *open = pos_;
+                length = walkArray([this](size_t){validate();});
+                if (failed()) return;
+                start_ = pos_ = open;
+            }
+            size_t begin, end;
+            s.range(length, begin, end);
+            walkArray([&](size_t i){
+                if (i >= begin && i < end)
+                    select(path, step + 1, out);
+                else
+                    validate();
+            });
+        }
+        else validate();
+    }
+};
+
+const Json &LazyNode::value() const{
+    Json *value = m_value.load(std::memory_order_acquire);
+    if (!value){
+        jParser p(m_begin, m_source->extents[m_index].end);
+        p.lazy(m_source, m_index + 1);
+        Json *fresh = new Json(p.parseLevel());
+        if (m_value.compare_exchange_strong(value, fresh, std::memory_order_acq_rel))
+            value = fresh;
+        else
+            delete fresh;
+    }
+    return *value;
+}
+
+
+
+//Two-stage parser
+//Stage one: 64-byte blocks are turned into bitmasks (quotes, backslashes, whitespace, operators),
+//escaped quotes and string contents are masked out with carry tricks and a prefix xor, and the
+//positions of the remaining structural characters and value starts are written to an index.
+struct BlockMasks{
+    uint64_t quote, backslash, space, op;
+};
+
+#ifndef LXJSON_X86_SIMD
+//the portable fallback of block_masks_sse2
+static void block_masks_scalar(const char *p, BlockMasks &m){
+    m = BlockMasks{0, 0, 0, 0};
+    for (int i = 0; i < 64; ++i){
+        uint64_t bit = uint64_t(1) << i;
+        switch (p[i]){
+            case '"':  m.quote |= bit; break;
+            case '\\': m.backslash |= bit; break;
+            case ' ': case '\t': case '\r': case '\n': m.space |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': m.op |= bit; break;
+            default: break;
+        }
+    }
+}
+#endif
+
+#ifdef LXJSON_X86_SIMD
+static inline uint64_t eq_mask16(__m128i x, char c){
+    return static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(c))));
+}
+
+static void block_masks_sse2(const char *p, BlockMasks &m){
+    m = BlockMasks{0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * i));
+        int shift = 16 * i;
+        m.quote     |= eq_mask16(x, '"') << shift;
+        m.backslash |= eq_mask16(x, '\\') << shift;
+        m.space     |= (eq_mask16(x, ' ') | eq_mask16(x, '\t') | eq_mask16(x, '\r') | eq_mask16(x, '\n')) << shift;
+        m.op        |= (eq_mask16(x, '{') | eq_mask16(x, '}') | eq_mask16(x, '[') | eq_mask16(x, ']')
+                        | eq_mask16(x, ':') | eq_mask16(x, ',')) << shift;
+    }
+}
+#endif
+
+static inline uint64_t prefix_xor(uint64_t x){
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+class StructuralIndexer final {
+public:
+    //writes the structural positions of buf[0, len) to out (room for len + 1 entries), returns their count
+    size_t index(const char *buf, size_t len, uint32_t *out){
+        uint32_t *tail = out;
+        size_t pos = 0;
+        for (; pos + 64 <= len; pos += 64)
+            tail = step(buf + pos, pos, tail);
+        if (pos < len){
+            //pad the last block with spaces, they can't change the meaning of what precedes them
+            char block[64];
+            memset(block, ' ', sizeof(block));
+            memcpy(block, buf + pos, len - pos);
+            tail = step(block, pos, tail);
+        }
+        return tail - out; //an unterminated string is left to stage two, it stops at its opening quote
+    }
+
+    //calls f(position) for every operator of buf[0, len) outside the strings, until it returns false.
+    //False when the text ends inside a string.
+    template<typename F>
+    bool operators(const char *buf, size_t len, F f){
+        for (size_t pos = 0; pos < len; pos += 64){
+            char block[64];
+            const char *p = buf + pos;
+            if (len - pos < 64){
+                memset(block, ' ', sizeof(block));
+                memcpy(block, p, len - pos);
+                p = block;
+            }
+            BlockMasks m;
+#ifdef LXJSON_X86_SIMD
+            block_masks_sse2(p, m);
+#else
+            block_masks_scalar(p, m);
+#endif
+            uint64_t quote = m.quote & ~escaped(m.backslash);
+            uint64_t in_string = prefix_xor(quote) ^ m_in_string;
+            m_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+            for (uint64_t ops = m.op & ~in_string; ops; ops &= ops - 1)
+                if (!f(pos + __builtin_ctzll(ops))) return true;
+        }
+        return !m_in_string;
+    }
+
+private:
+    uint64_t m_escaped = 0;       //the first byte of the next block is escaped
+    uint64_t m_in_string = 0;     //all ones when the next block starts inside a string
+    uint64_t m_follows_scalar = 0;//the last byte of the previous block was part of a scalar
+
+    //bits of the characters escaped by a backslash, whatever the length of the backslash run
+    uint64_t escaped(uint64_t backslash){
+        backslash &= ~m_escaped;
+        uint64_t follows_escape = backslash << 1 | m_escaped;
+        const uint64_t even_bits = 0x5555555555555555ULL;
+        uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+        uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+        m_escaped = sequences_starting_on_even_bits < backslash; //carry out of the block
+        uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+        return (even_bits ^ invert_mask) & follows_escape;
+    }
+
+    uint32_t *step(const char *block, size_t base, uint32_t *tail){
+        BlockMasks m;
+#ifdef LXJSON_X86_SIMD
+        block_masks_sse2(block, m);
+#else
+        block_masks_scalar(block, m);
+#endif
+        uint64_t quote = m.quote & ~escaped(m.backslash);
+        //1 from an opening quote up to (not including) its closing quote
+        uint64_t in_string = prefix_xor(quote) ^ m_in_string;
+        m_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        //a value starts on a non-space, non-operator byte that does not follow another such byte
+        uint64_t scalar = ~(m.op | m.space);
+        uint64_t nonquote_scalar = scalar & ~quote;
+        uint64_t follows_scalar = nonquote_scalar << 1 | m_follows_scalar;
+        m_follows_scalar = nonquote_scalar >> 63;
+        uint64_t structurals = (m.op | (scalar & ~follows_scalar)) & ~(in_string ^ quote);
+
+        while (structurals){
+            *tail++ = static_cast<uint32_t>(base + __builtin_ctzll(structurals));
+            structurals &= structurals - 1;
+        }
+        return tail;
+    }
+};
+
+//Stage two: the tape. Every word holds a type character in its top byte and a payload below:
+//  'r'      root, index one past the end of the tape
+//  '[' '{'  index one past the matching close word, element count in bits 32..55
+//  ']' '}'  index of the matching open word
+//  '"'      offset of the string in m_strings, stored as a 32-bit length followed by the bytes
+//  'l' 'u'  the next word holds the int64_t / uint64_t
+//  'd'      the next word holds the bits of the double
+//  't' 'f' 'n'
+static const uint64_t tape_payload_mask = (uint64_t(1) << 56) - 1;
+
+static inline uint64_t tape_word(char type, uint64_t payload){
+    return (static_cast<uint64_t>(static_cast<unsigned char>(type)) << 56) | payload;
+}
+static inline char tape_type(uint64_t word){
+    return static_cast<char>(word >> 56);
+}
+
+bool JsonTape::parse(const std::string &in, std::string &err) noexcept{
+    m_words.clear();
+    m_strings.clear();
+    try {
+        //positions and tape indexes are 32-bit, a number takes two words
+        if (in.size() >= std::numeric_limits<uint32_t>::max() / 2){
+            err = "document too large for the two-stage parser";
+            return false;
+        }
+        ParseStatus status;
+        if (build(in.c_str(), in.size(), status))
+            return true;
+        err = status.message();
+    } catch (std::bad_alloc&) {
+        err = "out of memory";
+    }
+    m_words.clear();
+    m_strings.clear();
+    return false;
+}
+
+//reports the errors of Json::parse, at the same positions: the first one in document order
+bool JsonTape::build(const char *buf, size_t len, ParseStatus &status){
+    using Error = ParseStatus::Error;
+    m_structurals.resize(len + 1);
+    StructuralIndexer indexer;
+    size_t count = indexer.index(buf, len, m_structurals.data());
+    const uint32_t *idx = m_structurals.data();
+    size_t i = 0;
+
+    //scalars are decoded by jParser, so both engines accept exactly the same values, and it keeps the error
+    jParser decoder(buf, buf + len);
+    auto fail = [&](Error error, const char *at){
+        decoder.fail(error, at);
+        status = decoder.status();
+        return false;
+    };
+    //`error` at the next structural character, or the end of the text
+    auto expected = [&](Error error){
+        return i == count ? fail(Error::UNEXPECTED_END, buf + len) : fail(error, buf + idx[i]);
+    };
+    auto decoded = [&]{
+        if (!decoder.failed()) return true;
+        status = decoder.status();
+        return false;
+    };
+
+    //open containers: tape index of the open word and number of elements so far
+    struct Frame{
+        size_t open;
+        size_t count;
+    };
+    vector<Frame> stack;
+    //what is missing when a value is followed by something else
+    auto after_value = [&]{
+        if (stack.empty()) return Error::TRAILING_CHARACTERS;
+        return tape_type(m_words[stack.back().open]) == '{' ? Error::EXPECTED_COMMA_OR_BRACE : Error::EXPECTED_COMMA_OR_BRACKET;
+    };
+    //a scalar must extend up to the next structural character, give or take whitespace
+    auto scalar_end = [&](const char *stop){
+        const char *limit = i < count ? buf + idx[i] : buf + len;
+        while (stop < limit && is_space(*stop)) ++stop;
+        return stop == limit || fail(after_value(), stop);
+    };
+    auto write_string = [&](const char *p){
+        size_t offset = m_strings.size();
+        m_strings.append(sizeof(uint32_t), '\0');
+        decoder.seek(p);
+        decoder.parseRawString(m_strings);
+        if (!decoded()) return false;
+        uint32_t length = static_cast<uint32_t>(m_strings.size() - offset - sizeof(uint32_t));
+        memcpy(&m_strings[offset], &length, sizeof(length));
+        m_words.push_back(tape_word('"', offset));
+        return true;
+    };
+
+    m_words.push_back(tape_word('r', 0));
+    //the limit of the other engines: to_json() recurses once per level
+    const size_t max_depth = ParseOptions().max_depth;
+    auto open_container = [&](const char *p){
+        if (stack.size() >= max_depth)
+            return fail(Error::TOO_DEEP, p);
+        stack.push_back({m_words.size(), 0});
+        m_words.push_back(tape_word(*p, 0));
+        return true;
+    };
+
+    enum class State {VALUE, OBJECT_START, OBJECT_KEY, ARRAY_START, AFTER_VALUE};
+    State state = State::VALUE;
+    while (true){
+        switch (state){
+            case State::VALUE: {
+                if (i == count) return fail(Error::UNEXPECTED_END, buf + len);
+                const char *p = buf + idx[i++];
+                switch (*p){
+                    case '{':
+                        if (!open_container(p)) return false;
+                        state = State::OBJECT_START;
+                        continue;
+                    case '[':
+                        if (!open_container(p)) return false;
+                        state = State::ARRAY_START;
+                        continue;
+                    case '"':
+                        if (!write_string(p) || !scalar_end(decoder.position())) return false;
+                        break;
+                    case 't': case 'f': case 'n': {
+                        const char *literal = *p == 't' ? "true" : *p == 'f' ? "false" : "null";
+                        size_t n = strlen(literal);
+                        if (strncmp(p, literal, n)) return fail(Error::INVALID_LITERAL, p);
+                        if (!scalar_end(p + n)) return false;
+                        m_words.push_back(tape_word(*p, 0));
+                        break;
+                    }
+                    case '}': case ']': case ':': case ',':
+                        return fail(Error::INVALID_VALUE, p);
+                    default: {
+                        decoder.seek(p);
+                        Json number = decoder.parseNum();
+                        if (!decoded() || !scalar_end(decoder.position())) return false;
+                        char type = number.m_kind == Json::Kind::K_INT ? 'l' : number.m_kind == Json::Kind::K_UINT ? 'u' : 'd';
+                        m_words.push_back(tape_word(type, 0));
+                        m_words.push_back(number.m_uint); //the raw 64 bits, whatever the kind
+                        break;
+                    }
+                }
+                state = State::AFTER_VALUE;
+                continue;
+            }
+            case State::OBJECT_START:
+            case State::ARRAY_START: {
+                char close = state == State::OBJECT_START ? '}' : ']';
+                if (i < count && buf[idx[i]] == close){
+                    ++i;
+                    break; //close the empty container below
+                }
+                state = state == State::OBJECT_START ? State::OBJECT_KEY : State::VALUE;
+                continue;
+            }
+            case State::OBJECT_KEY: {
+                if (i == count || buf[idx[i]] != '"') return expected(Error::EXPECTED_KEY);
+                if (!write_string(buf + idx[i++])) return false;
+                if (i == count || buf[idx[i]] != ':') return expected(Error::EXPECTED_COLON);
+                ++i;
+                state = State::VALUE;
+                continue;
+            }
+            case State::AFTER_VALUE: {
+                if (stack.empty()){
+                    if (i != count) return fail(Error::TRAILING_CHARACTERS, buf + idx[i]);
+                    m_words[0] = tape_word('r', m_words.size());
+                    return true;
+                }
+                ++stack.back().count;
+                bool in_object = tape_type(m_words[stack.back().open]) == '{';
+                if (i < count && buf[idx[i]] == ','){
+                    ++i;
+                    state = in_object ? State::OBJECT_KEY : State::VALUE;
+                    continue;
+                }
+                if (i == count || buf[idx[i]] != (in_object ? '}' : ']'))
+                    return expected(after_value());
+                ++i;
+                break; //close the container below
+            }
+        }
+        //close the innermost container
+        Frame frame = stack.back();
+        stack.pop_back();
+        char open = tape_type(m_words[frame.open]);
+        m_words.push_back(tape_word(open == '{' ? '}' : ']', frame.open));
+        uint64_t elements = std::min<uint64_t>(frame.count, (uint64_t(1) << 24) - 1);
+        m_words[frame.open] = tape_word(open, elements << 32 | m_words.size());
+        state = State::AFTER_VALUE;
+    }
+}
+
+size_t JsonTape::next(size_t index) const{
+    uint64_t word = m_words[index];
+    switch (tape_type(word)){
+        case '[': case '{': return static_cast<uint32_t>(word);
+        case 'l': case 'u': case 'd': return index + 2;
+        default: return index + 1;
+    }
+}
+
+Json::JsonType JsonTape::type(size_t index) const{
+    switch (tape_type(m_words[index])){
+        case '[': return Json::JsonType::T_ARRAY;
+        case '{': return Json::JsonType::T_OBJECT;
+        case '"': return Json::JsonType::T_STRING;
+        case 'l': case 'u': case 'd': return Json::JsonType::T_NUMBER;
+        case 't': case 'f': return Json::JsonType::T_BOOL;
+        default: return Json::JsonType::T_NULL;
+    }
+}
+
+static string tape_string(const string &strings, uint64_t word){
+    size_t offset = word & tape_payload_mask;
+    uint32_t length;
+    memcpy(&length, strings.data() + offset, sizeof(length));
+    return string(strings.data() + offset + sizeof(length), length);
+}
+
+Json JsonTape::to_json(size_t index) const{
+    uint64_t word = m_words[index];
+    switch (tape_type(word)){
+        case '"':
+            return Json(tape_string(m_strings, word));
+        case 'l':
+            return Json(static_cast<int64_t>(m_words[index + 1]));
+        case 'u':
+            return Json(m_words[index + 1]);
+        case 'd': {
+            double value;
+            memcpy(&value, &m_words[index + 1], sizeof(value));
+            return Json(value);
+        }
+        case 't': return Json(true);
+        case 'f': return Json(false);
+        case 'n': return Json(nullptr);
+        case '[': {
+            Json::array data;
+            data.reserve((word >> 32) & 0xFFFFFF);
+            size_t end = static_cast<uint32_t>(word) - 1;
+            for (size_t i = index + 1; i < end; i = next(i))
+                data.push_back(to_json(i));
+            return Json(std::move(data));
+        }
+        case '{': {
+            Json::object data;
+            size_t end = static_cast<uint32_t>(word) - 1;
+            for (size_t i = index + 1; i < end; i = next(i + 1))
+                data.emplace(tape_string(m_strings, m_words[i]), to_json(i + 1));
+            return Json(std::move(data));
+        }
+        default:
+            throw std::runtime_error("not a value");
+    }
+}
+
+//Streaming parser
+//A state machine over the structural characters, the values themselves are decoded by jParser,
+//straight from the chunk when they fit in it, or from m_token when they straddle two chunks.
+static inline bool is_scalar_char(char c){
+    return in_range(c, '0', '9') || in_range(c, 'a', 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+void JsonStream::emit(bool go_on){
+    if (!go_on) throw std::runtime_error("stopped by the handler");
+}
+
+//the lines of the input up to `end`: the bytes before the chunk are those of the current token
+void JsonStream::count_lines(size_t end){
+    auto count = [&](const char *begin, const char *stop, size_t at){
+        if (stop <= begin) return;
+        for (const char *p = begin; (p = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(stop - p)))); ++p){
+            ++m_line;
+            m_line_begin = at + static_cast<size_t>(p - begin) + 1;
+        }
+    };
+    if (m_counted < m_offset){
+        size_t stop = std::min(end, m_offset);
+        count(m_token.data() + (m_counted - m_token_offset), m_token.data() + (stop - m_token_offset), m_counted);
+    }
+    size_t from = std::max(m_counted, m_offset);
+    if (end > from) count(m_chunk + (from - m_offset), m_chunk + (end - m_offset), from);
+    m_counted = std::max(m_counted, end);
+}
+
+//the error at offset `at` of the input, with the message of Json::parse
+void JsonStream::fail(ParseStatus::Error error, size_t at){
+    count_lines(at);
+    m_status.error = error;
+    m_status.offset = at;
+    m_status.line = m_line;
+    m_status.column = at - m_line_begin + 1;
+    throw std::runtime_error(m_status.message());
+}
+
+//a value is complete, what comes next depends on the enclosing container
+void JsonStream::value_done(){
+    m_state = m_stack.empty() ? State::DONE : State::AFTER_VALUE;
+}
+
+//what is missing when a value is followed by something else
+ParseStatus::Error JsonStream::after_value() const{
+    if (m_stack.empty()) return ParseStatus::Error::TRAILING_CHARACTERS;
+    return m_stack.back() == '[' ? ParseStatus::Error::EXPECTED_COMMA_OR_BRACKET : ParseStatus::Error::EXPECTED_COMMA_OR_BRACE;
+}
+
+void JsonStream::start_token(const char *p, State state){
+    m_state = state;
+    m_token_begin = p;
+    m_token_offset = offset(p);
+}
+
+const char *JsonStream::start_value(const char *p){
+    switch (*p){
+        case '[':
+            emit(m_handler.start_array());
+            m_stack.push_back('[');
+            m_state = State::ARRAY_START;
+            return p + 1;
+        case '{':
+            emit(m_handler.start_object());
+            m_stack.push_back('{');
+            m_state = State::OBJECT_START;
+            return p + 1;
+        case '"':
+            m_is_key = false;
+            start_token(p, State::STRING);
+            return p + 1;
+        case 't': case 'f': case 'n':
+            start_token(p, State::LITERAL);
+            return p;
+        default:
+            if (*p != '-' && !in_range(*p, '0', '9')) fail(ParseStatus::Error::INVALID_VALUE, offset(p));
+            start_token(p, State::NUMBER);
+            return p;
+    }
+}
+
+void JsonStream::end_container(){
+    char open = m_stack.back();
+    m_stack.pop_back();
+    emit(open == '[' ? m_handler.end_array() : m_handler.end_object());
+    value_done();
+}
+
+//*p is the first byte that is not a whitespace
+const char *JsonStream::structural(const char *p){
+    switch (m_state){
+        case State::VALUE:
+            return start_value(p);
+        case State::ARRAY_START:
+            if (*p != ']') return start_value(p);
+            end_container();
+            return p + 1;
+        case State::OBJECT_START:
+            if (*p == '}'){
+                end_container();
+                return p + 1;
+            }
+            //fall through
+        case State::OBJECT_KEY:
+            if (*p != '"') fail(ParseStatus::Error::EXPECTED_KEY, offset(p));
+            m_is_key = true;
+            start_token(p, State::STRING);
+            return p + 1;
+        case State::COLON:
+            if (*p != ':') fail(ParseStatus::Error::EXPECTED_COLON, offset(p));
+            m_state = State::VALUE;
+            return p + 1;
+        case State::AFTER_VALUE:
+            if (*p == ',')
+                m_state = m_stack.back() == '[' ? State::VALUE : State::OBJECT_KEY;
+            else if (*p == (m_stack.back() == '[' ? ']' : '}'))
+                end_container();
+            else
+                fail(after_value(), offset(p));
+            return p + 1;
+        default:
+            fail(ParseStatus::Error::TRAILING_CHARACTERS, offset(p));
+    }
+}
+
+//look for the closing quote, the token is decoded once it is found
+const char *JsonStream::string_token(const char *p, const char *end){
+    while (p < end){
+        if (m_escape){
+            m_escape = false;
+            ++p;
+            continue;
+        }
+        p = scanners.scan_string(p, end);
+        if (p == end) break;
+        if (*p == '"'){
+            end_token(m_token_begin, ++p);
+            return p;
+        }
+        if (*p != '\\'){
+            //a control character: decoding up to it fails on the first error of the string, which may
+            //be an escape before it
+            end_token(m_token_begin, p + 1);
+        }
+        m_escape = true;
+        ++p;
+    }
+    m_token.append(m_token_begin, end);
+    return end;
+}
+
+//numbers and literals end with the first byte that can't be part of them
+const char *JsonStream::scalar_token(const char *p, const char *end){
+    while (p < end && is_scalar_char(*p)) ++p;
+    if (p == end){
+        m_token.append(m_token_begin, end);
+        return end;
+    }
+    end_token(m_token_begin, p);
+    return p;
+}
+
+//decode the token that ends at `end`, it started at `begin` in the same chunk unless m_token holds its start
+void JsonStream::end_token(const char *begin, const char *end){
+    if (!m_token.empty()){
+        m_token.append(begin, end);
+        begin = m_token.data();
+        end = begin + m_token.size();
+    }
+    //the byte after a token in a chunk is a delimiter, and the one after m_token a '\0'
+    jParser parser(begin, end);
+    auto check = [&]{
+        if (parser.failed()) fail(parser.status().error, m_token_offset + parser.status().offset);
+    };
+    if (m_state == State::STRING){
+        m_value.clear();
+        parser.parseRawString(m_value);
+        check();
+        if (m_is_key){
+            emit(m_handler.key(m_value));
+            m_state = State::COLON;
+        }
+        else {
+            emit(m_handler.on_string(m_value));
+            value_done();
+        }
+    }
+    else {
+        Json value = m_state == State::LITERAL ? parser.parse() : parser.parseNum();
+        check();
+        if (parser.position() != end) fail(after_value(), m_token_offset + static_cast<size_t>(parser.position() - begin));
+        if (value.is_null()) emit(m_handler.on_null());
+        else if (value.is_bool()) emit(m_handler.on_bool(value.bool_value()));
+        else emit(m_handler.on_number(value));
+        value_done();
+    }
+    m_token.clear();
+    m_counted = std::max(m_counted, m_offset); //a complete token holds no newline
+}
+
+bool JsonStream::feed(const char *data, size_t size, string &err) noexcept{
+    if (m_state == State::FAILED){
+        err = m_error;
+        return false;
+    }
+    const char *p = data, *end = data + size;
+    m_chunk = data;
+    try {
+        //a token left open by the previous chunk goes on at the start of this one
+        m_token_begin = p;
+        while (p < end){
+            switch (m_state){
+                case State::STRING:
+                    p = string_token(p, end);
+                    break;
+                case State::NUMBER: case State::LITERAL:
+                    p = scalar_token(p, end);
+                    break;
+                default:
+                    p = scanners.skip_space(p, end);
+                    if (p == end) break;
+                    p = structural(p);
+                    //a token that starts here must be scanned, or buffered, before the chunk goes away
+                    if (m_state == State::STRING) p = string_token(p, end);
+                    else if (m_state == State::NUMBER || m_state == State::LITERAL) p = scalar_token(p, end);
+            }
+        }
+        //the lines of the chunk, up to the token it leaves open
+        bool open = m_state == State::STRING || m_state == State::NUMBER || m_state == State::LITERAL;
+        count_lines(open ? m_token_offset : m_offset + size);
+        m_offset += size;
+        return true;
+    } catch (std::runtime_error &e) {
+        m_state = State::FAILED;
+        err = m_error = e.what();
+        return false;
+    }
+}
+
+bool JsonStream::finish(string &err) noexcept{
+    if (m_state == State::FAILED){
+        err = m_error;
+        return false;
+    }
+    m_chunk = nullptr;
+    try {
+        //an unterminated string fails there, on its first error
+        if (m_state == State::STRING || m_state == State::NUMBER || m_state == State::LITERAL)
+            end_token(m_token.data(), m_token.data());
+        if (m_state != State::DONE) fail(ParseStatus::Error::UNEXPECTED_END, m_offset);
+        return true;
+    } catch (std::runtime_error &e) {
+        m_state = State::FAILED;
+        err = m_error = e.what();
+        return false;
+    }
+}
+
+void JsonStream::reset(){
+    m_state = State::VALUE;
+    m_escape = false;
+    m_stack.clear();
+    m_token.clear();
+    m_error.clear();
+    m_status = ParseStatus();
+    m_offset = m_token_offset = m_counted = m_line_begin = 0;
+    m_line = 1;
+}
+
+
+static Json parse_document(jParser &p, ParseStatus &status) noexcept{
+    p.skipSpace();
+    Json result = p.parse();
+    p.expectEnd();
+    status = p.status();
+    return status.ok() ? result : Json(nullptr);
+}
+
+//the parse functions that report a message are thin wrappers over the status
+static Json parse_document(jParser &p, string &err) noexcept{
+    ParseStatus status;
+    Json result = parse_document(p, status);
+    if (!status.ok()) err = status.message();
+    return result;
+}
+
+Json Json::parse(const string &in, ParseStatus &status, const ParseOptions &options) noexcept{
+    jParser p(in);
+    p.max_depth(options.max_depth);
+    p.validate_utf8(options.validate_utf8);
+    return parse_document(p, status);
+}
+
+Json Json::parse(const string &in, string &err) noexcept{
+    jParser p(in);
+    return parse_document(p, err);
+}
+
+Json Json::parse(const char *in, string &err) noexcept{
+    if (!in){
+        err = "null input";
+        return Json(nullptr);
+    }
+    jParser p(in, in + strlen(in));
+    return parse_document(p, err);
+}
+
+Json Json::parse(const string &in, string &err, Arena &arena) noexcept{
+    jParser p(in, &arena);
+    return parse_document(p, err);
+}
+
+Json Json::parse(const string &in, string &err, KeyTable &keys) noexcept{
+    jParser p(in);
+    p.intern_keys(&keys);
+    return parse_document(p, err);
+}
+
+//the whole text is checked first, then kept by the lazy containers, the root one included
+static Json parse_lazy(const string &in, string &err) noexcept{
+    std::shared_ptr<LazySource> source = std::make_shared<LazySource>();
+    source->text = in;
+    jParser check(source->text);
+    check.record_extents(&source->extents);
+    check.skipSpace();
+    check.validate();
+    check.expectEnd();
+    if (check.failed()){
+        err = check.status().message();
+        return Json(nullptr);
+    }
+    jParser p(source->text);
+    p.lazy(std::move(source), 0);
+    return parse_document(p, err);
+}
+
+Json Json::parse(const string &in, string &err, ParseEngine engine) noexcept{
+    if (engine == ParseEngine::RECURSIVE_DESCENT)
+        return parse(in, err);
+    if (engine == ParseEngine::LAZY)
+        return parse_lazy(in, err);
+    if (engine == ParseEngine::PARALLEL)
+        return parse_parallel(in, err);
+    JsonTape tape;
+    if (!tape.parse(in, err))
+        return Json(nullptr);
+    return tape.to_json();
+}
+
+Json Json::parse(const string &in, string &err, std::shared_ptr<Arena> arena) noexcept{
+    if (!arena) return parse(in, err);
+    Arena *raw = arena.get();
+    jParser p(in, raw);
+    Json result = parse_document(p, err);
+    //from now on the nodes keep the arena alive, the last one to go releases it
+    if (raw->m_nodes.load(std::memory_order_acquire))
+        raw->m_self = std::move(arena);
+    return result;
+}
+
+//Parser
+Json::Parser::Parser(size_t arena_chunk) : m_buffers(new ParseBuffers), m_arena_chunk(arena_chunk){}
+
+Json::Parser::~Parser(){}
+
+Json Json::Parser::parse(const string &in, ParseStatus &status, const ParseOptions &options) noexcept{
+    Arena *arena = nullptr;
+    if (m_arena_chunk){
+        //the arena of the last document is only held by the parser once that document is gone
+        if (m_arena.use_count() == 1){
+            std::atomic_thread_fence(std::memory_order_acquire); //its last node may have gone on another thread
+            m_arena->rewind();
+        }
+        else m_arena = std::make_shared<Arena>(m_arena_chunk);
+        arena = m_arena.get();
+    }
+    jParser p(in, arena);
+    p.max_depth(options.max_depth);
+    p.validate_utf8(options.validate_utf8);
+    p.use_buffers(*m_buffers);
+#ifdef LXJSON_FLAT_OBJECT
+    //a table for all the documents, started over when the keys keep changing
+    if (!m_buffers->keys || m_buffers->keys->size() > 4096) m_buffers->keys.reset(new KeyTable);
+    p.intern_keys(m_buffers->keys.get());
+#endif
+    Json result = parse_document(p, status);
+    if (arena && arena->m_nodes.load(std::memory_order_acquire))
+        arena->m_self = m_arena;
+    return result;
+}
+
+Json Json::Parser::parse(const string &in, string &err) noexcept{
+    ParseStatus status;
+    Json result = parse(in, status);
+    if (!status.ok()) err = status.message();
+    return result;
+}
+
+//CBOR
+//the major types of the initial byte, in its top 3 bits
+enum CborMajor : unsigned char {
+    CBOR_UINT = 0, CBOR_NEGATIVE = 1, CBOR_BYTES = 2, CBOR_TEXT = 3, CBOR_ARRAY = 4, CBOR_MAP = 5,
+    CBOR_TAG = 6, CBOR_SIMPLE = 7
+};
+static const unsigned char cbor_indefinite = 31, cbor_break = 0xff;
+
+//initial byte and argument, the argument in as few bytes as possible, big-endian
+static size_t cbor_head_size(uint64_t value){
+    return value < 24 ? 1 : value <= 0xff ? 2 : value <= 0xffff ? 3 : value <= 0xffffffff ? 5 : 9;
+}
+static unsigned char *write_be(uint64_t value, size_t bytes, unsigned char *p){
+    for (size_t i = bytes; i--; value >>= 8) p[i] = static_cast<unsigned char>(value);
+    return p + bytes;
+}
+static unsigned char *write_cbor_head(unsigned char major, uint64_t value, unsigned char *p){
+    major = static_cast<unsigned char>(major << 5);
+    if (value < 24){
+        *p = static_cast<unsigned char>(major | value);
+        return p + 1;
+    }
+    size_t bytes = cbor_head_size(value) - 1;
+    *p = static_cast<unsigned char>(major | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+    return write_be(value, bytes, p + 1);
+}
+
+//a float holds the double exactly, NaN included
+static bool fits_float(double value){
+    if (value != value) return true;
+    if (std::fabs(value) > std::numeric_limits<float>::max() && !std::isinf(value)) return false;
+    return static_cast<double>(static_cast<float>(value)) == value;
+}
+
+static size_t cbor_size(StringView text){
+    return cbor_head_size(text.size) + text.size;
+}
+static unsigned char *write_cbor(StringView text, unsigned char *p){
+    p = write_cbor_head(CBOR_TEXT, text.size, p);
+    memcpy(p, text.data, text.size);
+    return p + text.size;
+}
+
+size_t Json::cbor_size() const{
+    switch (m_kind){
+        case Kind::K_NULL:
+        case Kind::K_BOOL:   return 1;
+        case Kind::K_INT:    return cbor_head_size(m_int < 0 ? ~static_cast<uint64_t>(m_int) : static_cast<uint64_t>(m_int));
+        case Kind::K_UINT:   return 9;
+        case Kind::K_DOUBLE: return fits_float(m_double) ? 5 : 9;
+        case Kind::K_STRING: {
+            const string &value = as_string(m_node)->m_value;
+            return lxjson::cbor_size(StringView{value.data(), value.size()});
+        }
+        case Kind::K_STRING_VIEW: return lxjson::cbor_size(string_view());
+        case Kind::K_ARRAY: {
+            const array &values = as_array(m_node)->m_value;
+            size_t total = cbor_head_size(values.size());
+            for (auto &value : values) total += value.cbor_size();
+            return total;
+        }
+        case Kind::K_OBJECT: {
+            const object &values = as_object(m_node)->m_value;
+            size_t total = cbor_head_size(values.size());
+            for (auto &member : values){
+                const string &key = member.first;
+                total += lxjson::cbor_size(StringView{key.data(), key.size()}) + member.second.cbor_size();
+            }
+            return total;
+        }
+        default: return as_lazy(m_node)->value().cbor_size();
+    }
+}
+
+unsigned char *Json::write_cbor(unsigned char *p) const{
+    switch (m_kind){
+        case Kind::K_NULL:   *p = 0xf6; return p + 1;
+        case Kind::K_BOOL:   *p = m_bool ? 0xf5 : 0xf4; return p + 1;
+        case Kind::K_INT:
+            //a negative n is written as -1 - n, which is ~n in two's complement
+            return m_int < 0 ? write_cbor_head(CBOR_NEGATIVE, ~static_cast<uint64_t>(m_int), p)
+                             : write_cbor_head(CBOR_UINT, static_cast<uint64_t>(m_int), p);
+        case Kind::K_UINT:   return write_cbor_head(CBOR_UINT, m_uint, p);
+        case Kind::K_DOUBLE: {
+            if (fits_float(m_double)){
+                float value = static_cast<float>(m_double);
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                *p = 0xfa;
+                return write_be(bits, 4, p + 1);
+            }
+            uint64_t bits;
+            memcpy(&bits, &m_double, sizeof(bits));
+            *p = 0xfb;
+            return write_be(bits, 8, p + 1);
+        }
+        case Kind::K_STRING: {
+            const string &value = as_string(m_node)->m_value;
+            return lxjson::write_cbor(StringView{value.data(), value.size()}, p);
+        }
+        case Kind::K_STRING_VIEW: return lxjson::write_cbor(string_view(), p);
+        case Kind::K_ARRAY: {
+            const array &values = as_array(m_node)->m_value;
+            p = write_cbor_head(CBOR_ARRAY, values.size(), p);
+            for (auto &value : values) p = value.write_cbor(p);
+            return p;
+        }
+        case Kind::K_OBJECT: {
+            const object &values = as_object(m_node)->m_value;
+            p = write_cbor_head(CBOR_MAP, values.size(), p);
+            for (auto &member : values){
+                const string &key = member.first;
+                p = lxjson::write_cbor(StringView{key.data(), key.size()}, p);
+                p = member.second.write_cbor(p);
+            }
+            return p;
+        }
+        default: return as_lazy(m_node)->value().write_cbor(p);
+    }
+}
+
+//the size is exact, so the output grows once
+void Json::to_cbor(string &out) const{
+    size_t at = out.size(), size = cbor_size();
+    out.resize(at + size);
+    unsigned char *begin = reinterpret_cast<unsigned char *>(&out[0]) + at;
+    if (write_cbor(begin) != begin + size) throw std::runtime_error("cbor_size() is wrong");
+}
+
+//One pass over the buffer, errors are thrown and reported by Json::from_cbor
+class CborReader final {
+public:
+    CborReader(const unsigned char *begin, const unsigned char *end) : pos_(begin), end_(end) {}
+
+    Json document(){
+        Json result = item(0);
+        if (pos_ != end_) throw std::runtime_error("unexpected trailing bytes after the CBOR item");
         return result;
-    } catch (std::runtime_error& e) {
+    }
+
+private:
+    //deep enough for any document, shallow enough for the stack
+    static const unsigned max_depth = 512;
+
+    const unsigned char *pos_;
+    const unsigned char *end_;
+#ifdef LXJSON_FLAT_OBJECT
+    KeyTable keys_; //like the text parser, the keys are interned per document
+    string key_buf_;
+#endif
+
+    size_t remaining() const{
+        return static_cast<size_t>(end_ - pos_);
+    }
+    void need(size_t n) const{
+        if (remaining() < n) throw std::runtime_error("truncated CBOR input");
+    }
+    uint64_t read_be(size_t bytes){
+        need(bytes);
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) value = value << 8 | pos_[i];
+        pos_ += bytes;
+        return value;
+    }
+    //the argument that follows an initial byte, cbor_indefinite is left to the caller
+    uint64_t argument(unsigned char info){
+        if (info < 24) return info;
+        switch (info){
+            case 24: return read_be(1);
+            case 25: return read_be(2);
+            case 26: return read_be(4);
+            case 27: return read_be(8);
+            default: throw std::runtime_error("invalid CBOR argument " + std::to_string(info));
+        }
+    }
+    //a length that can't exceed the rest of the input, each element taking at least `unit` bytes
+    size_t length(unsigned char info, size_t unit){
+        uint64_t n = argument(info);
+        if (n > remaining() / unit) throw std::runtime_error("truncated CBOR input");
+        return static_cast<size_t>(n);
+    }
+    bool at_break(){
+        need(1);
+        if (*pos_ != cbor_break) return false;
+        ++pos_;
+        return true;
+    }
+
+    void text(unsigned char info, string &out){
+        if (info != cbor_indefinite){
+            size_t n = length(info, 1);
+            out.append(reinterpret_cast<const char *>(pos_), n);
+            pos_ += n;
+            return;
+        }
+        //chunks of definite length, up to a break
+        while (!at_break()){
+            unsigned char head = *pos_++;
+            if (head >> 5 != CBOR_TEXT || (head & 31) == cbor_indefinite)
+                throw std::runtime_error("invalid chunk in an indefinite-length string");
+            text(head & 31, out);
+        }
+    }
+
+    static double half_to_double(uint16_t half){
+        int exponent = half >> 10 & 0x1f, mantissa = half & 0x3ff;
+        double value = exponent == 0 ? std::ldexp(mantissa, -24)
+                     : exponent == 31 ? (mantissa ? std::numeric_limits<double>::quiet_NaN() : INFINITY)
+                     : std::ldexp(mantissa + 1024, exponent - 25);
+        return half & 0x8000 ? -value : value;
+    }
+
+    Json simple(unsigned char info){
+        switch (info){
+            case 20: return Json(false);
+            case 21: return Json(true);
+            case 22:
+            case 23: return Json(nullptr); //undefined has no JSON equivalent closer than null
+            case 25: return Json(half_to_double(static_cast<uint16_t>(read_be(2))));
+            case 26: {
+                uint32_t bits = static_cast<uint32_t>(read_be(4));
+                float value;
+                memcpy(&value, &bits, sizeof(value));
+                return Json(static_cast<double>(value));
+            }
+            case 27: {
+                uint64_t bits = read_be(8);
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                return Json(value);
+            }
+            default: throw std::runtime_error("unsupported CBOR simple value " + std::to_string(info));
+        }
+    }
+
+    Json array(unsigned char info, unsigned depth){
+        Json::array data;
+        if (info == cbor_indefinite){
+            while (!at_break()) data.push_back(item(depth + 1));
+        }
+        else {
+            size_t n = length(info, 1);
+            data.reserve(n);
+            for (size_t i = 0; i < n; ++i) data.push_back(item(depth + 1));
+        }
+        return Json(std::move(data));
+    }
+
+#ifdef LXJSON_FLAT_OBJECT
+    //a key of definite length is interned straight from the input
+    JsonKey key(unsigned char info){
+        if (info == cbor_indefinite){
+            key_buf_.clear();
+            text(info, key_buf_);
+            return keys_.intern(key_buf_);
+        }
+        size_t n = length(info, 1);
+        const char *begin = reinterpret_cast<const char *>(pos_);
+        pos_ += n;
+        return keys_.intern(begin, n);
+    }
+#else
+    string key(unsigned char info){
+        string out;
+        text(info, out);
+        return out;
+    }
+#endif
+
+    Json map(unsigned char info, unsigned depth){
+        Json::object data;
+        bool indefinite = info == cbor_indefinite;
+        size_t n = indefinite ? 0 : length(info, 2);
+#ifdef LXJSON_FLAT_OBJECT
+        data.reserve(n);
+#endif
+        for (size_t i = 0; indefinite ? !at_break() : i < n; ++i){
+            need(1);
+            unsigned char head = *pos_++;
+            if (head >> 5 != CBOR_TEXT) throw std::runtime_error("CBOR map keys must be text strings");
+            auto name = key(head & 31);
+            data.emplace(std::move(name), item(depth + 1));
+        }
+        return Json(std::move(data));
+    }
+
+    Json item(unsigned depth){
+        if (depth > max_depth) throw std::runtime_error("CBOR nesting deeper than " + std::to_string(max_depth));
+        need(1);
+        unsigned char head = *pos_++, info = head & 31;
+        switch (head >> 5){
+            case CBOR_UINT:
+                return Json(argument(info));
+            case CBOR_NEGATIVE: {
+                uint64_t n = argument(info);
+                if (n <= static_cast<uint64_t>(INT64_MAX)) return Json(-1 - static_cast<int64_t>(n));
+                return Json(-1.0 - static_cast<double>(n));
+            }
+            case CBOR_BYTES:
+                throw std::runtime_error("CBOR byte strings have no JSON equivalent");
+            case CBOR_TEXT: {
+                string value;
+                text(info, value);
+                return Json(std::move(value));
+            }
+            case CBOR_ARRAY:
+                return array(info, depth);
+            case CBOR_MAP:
+                return map(info, depth);
+            case CBOR_TAG:
+                argument(info); //the value stands for itself
+                return item(depth + 1);
+            default:
+                return simple(info);
+        }
+    }
+};
+
+Json Json::from_cbor(const char *data, size_t size, string &err) noexcept{
+    const unsigned char *begin = reinterpret_cast<const unsigned char *>(data);
+    try {
+        CborReader reader(begin, begin + size);
+        return reader.document();
+    } catch (std::runtime_error &e) {
         err = e.what();
-        //std::cout << err << std::endl;
         return Json(nullptr);
     }
+}
+
+//Paths
+//an optionally negative integer at expr[pos], false when there is none. Saturates, which makes no
+//difference for an index.
+static bool read_path_integer(const string &expr, size_t &pos, int64_t &value){
+    size_t p = pos;
+    bool negative = p < expr.size() && expr[p] == '-';
+    if (negative) ++p;
+    if (p == expr.size() || !in_range(expr[p], '0', '9')) return false;
+    int64_t v = 0;
+    for (; p < expr.size() && in_range(expr[p], '0', '9'); ++p)
+        if (v < INT64_MAX / 10 - 10) v = v * 10 + (expr[p] - '0');
+    value = negative ? -v : v;
+    pos = p;
+    return true;
+}
+
+JsonPath::JsonPath(const string &expression){
+    const size_t size = expression.size();
+    size_t pos = 0;
+    auto fail = [&](const string &what){
+        throw std::runtime_error(what + " in path at position " + std::to_string(pos));
+    };
+    if (pos < size && expression[pos] == '$') ++pos;
+    //without the '$', the path may start with a name: "a.b"
+    bool bare_name = pos == 0 && size && expression[0] != '.' && expression[0] != '[';
+    while (pos < size){
+        Step step{Step::Kind::NAME, string(), 0, INT64_MAX};
+        if (expression[pos] == '.' || bare_name){
+            if (!bare_name) ++pos;
+            bare_name = false;
+            if (pos < size && expression[pos] == '*'){
+                ++pos;
+                step.kind = Step::Kind::WILDCARD;
+            }
+            else {
+                size_t begin = pos;
+                while (pos < size && expression[pos] != '.' && expression[pos] != '[') ++pos;
+                if (pos == begin) fail("expected a member name");
+                step.name = expression.substr(begin, pos - begin);
+            }
+        }
+        else if (expression[pos] == '['){
+            ++pos;
+            if (pos < size && (expression[pos] == '\'' || expression[pos] == '"')){
+                char quote = expression[pos++];
+                while (true){
+                    if (pos == size) fail("unterminated name");
+                    char c = expression[pos++];
+                    if (c == quote) break;
+                    if (c == '\\'){
+                        if (pos == size) fail("unterminated name");
+                        c = expression[pos++];
+                    }
+                    step.name += c;
+                }
+            }
+            else if (pos < size && expression[pos] == '*'){
+                ++pos;
+                step.kind = Step::Kind::WILDCARD;
+            }
+            else {
+                bool has_start = read_path_integer(expression, pos, step.start);
+                if (pos < size && expression[pos] == ':'){
+                    ++pos;
+                    step.kind = Step::Kind::SLICE;
+                    read_path_integer(expression, pos, step.stop);
+                }
+                else if (has_start) step.kind = Step::Kind::INDEX;
+                else fail("expected an index, a slice, '*' or a quoted name");
+            }
+            if (pos == size || expression[pos] != ']') fail("expected ']'");
+            ++pos;
+        }
+        else fail(string("unexpected '") + expression[pos] + "'");
+        m_steps.push_back(std::move(step));
+    }
+}
+
+JsonPath JsonPath::pointer(const string &pointer){
+    JsonPath path;
+    if (pointer.empty()) return path; //the whole document
+    if (pointer[0] != '/') throw std::runtime_error("a JSON pointer must start with '/'");
+    for (size_t pos = 1; ; ++pos){
+        Step step{Step::Kind::NAME, string(), 0, INT64_MAX};
+        for (; pos < pointer.size() && pointer[pos] != '/'; ++pos){
+            char c = pointer[pos];
+            if (c == '~'){
+                char next = pos + 1 < pointer.size() ? pointer[pos + 1] : '\0';
+                if (next != '0' && next != '1')
+                    throw std::runtime_error("invalid escape in JSON pointer at position " + std::to_string(pos));
+                c = next == '0' ? '~' : '/';
+                ++pos;
+            }
+            step.name += c;
+        }
+        //digits without a leading zero also index arrays, "-" (past the end) never matches anything
+        const string &token = step.name;
+        size_t pos_digits = 0;
+        int64_t index;
+        if (!token.empty() && (token == "0" || token[0] != '0')
+            && read_path_integer(token, pos_digits, index) && pos_digits == token.size() && token[0] != '-'){
+            step.kind = Step::Kind::NAME_OR_INDEX;
+            step.start = index;
+        }
+        path.m_steps.push_back(std::move(step));
+        if (pos == pointer.size()) break;
+    }
+    return path;
+}
+
+//a bound counted from the end when negative, clamped to [0, length]
+static size_t resolve_bound(int64_t bound, size_t length){
+    if (bound >= 0) return std::min(static_cast<size_t>(bound), length);
+    size_t back = static_cast<size_t>(-(bound + 1)) + 1;
+    return back >= length ? 0 : length - back;
+}
+
+void JsonPath::Step::range(size_t length, size_t &begin, size_t &end) const{
+    begin = end = 0;
+    switch (kind){
+        case Kind::WILDCARD:
+            end = length;
+            break;
+        case Kind::INDEX:
+        case Kind::NAME_OR_INDEX: {
+            if (start < 0 && static_cast<size_t>(-(start + 1)) >= length) break;
+            size_t i = resolve_bound(start, length);
+            if (i < length){
+                begin = i;
+                end = i + 1;
+            }
+            break;
+        }
+        case Kind::SLICE:
+            begin = resolve_bound(start, length);
+            end = std::max(begin, resolve_bound(stop, length));
+            break;
+        default:
+            break;
+    }
+}
+
+const Json *JsonPath::find(const Json &root) const{
+    const Json *first = nullptr;
+    visit(root, [&first](const Json &match){
+        if (!first) first = &match;
+    });
+    return first;
+}
+
+std::vector<Json> JsonPath::select(const Json &root) const{
+    std::vector<Json> out;
+    visit(root, [&out](const Json &match){
+        out.push_back(match);
+    });
+    return out;
+}
+
+std::vector<Json> JsonPath::select(const string &text, string &err) const noexcept{
+    std::vector<Json> out;
+    jParser p(text);
+    p.skipSpace();
+    p.select(*this, 0, out);
+    p.expectEnd();
+    if (p.failed()){
+        err = p.status().message();
+        out.clear();
+    }
+    return out;
+}
+
+//read-only mapping of a whole file, followed by at least one '\0' as the parser expects: the end
+//of the last page is zero-filled, and when the file fills it exactly an anonymous page follows it
+class MappedFile final {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){
+        if (m_base) munmap(m_base, m_mapped);
+    }
+
+    bool open(const string &path, string &err){
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0){
+            err = "cannot open " + path + ": " + strerror(errno);
+            return false;
+        }
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && map(fd, static_cast<size_t>(st.st_size));
+        if (!ok) err = "cannot map " + path + ": " + strerror(errno);
+        ::close(fd);
+        return ok;
+    }
+
+    const char *begin() const {return static_cast<const char *>(m_base);}
+    const char *end() const {return begin() + m_size;}
+
+private:
+    void *m_base = nullptr;
+    size_t m_size = 0;
+    size_t m_mapped = 0;
+
+    bool map(int fd, size_t size){
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t mapped = (size / page + 1) * page;
+        void *base = mmap(nullptr, mapped, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) return false;
+        if (size && mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED){
+            munmap(base, mapped);
+            return false;
+        }
+        madvise(base, size, MADV_SEQUENTIAL);
+        m_base = base;
+        m_size = size;
+        m_mapped = mapped;
+        return true;
+    }
+};
+
+Json Json::parse_file(const string &path, string &err, StringStorage storage) noexcept{
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(path, err))
+        return Json(nullptr);
+    if (storage == StringStorage::COPY){
+        jParser p(file->begin(), file->end());
+        return parse_document(p, err);
+    }
+    std::shared_ptr<Arena> arena = std::make_shared<Arena>(1 << 20);
+    Arena *raw = arena.get();
+    jParser p(file->begin(), file->end(), raw, true);
+    Json result = parse_document(p, err);
+    //the nodes keep the arena alive, and the arena keeps the mapping their views point into
+    if (raw->m_nodes.load(std::memory_order_acquire)){
+        raw->m_backing = std::move(file);
+        raw->m_self = std::move(arena);
+    }
+    return result;
+}
+
+
+
+//Thread pool
+//the thread count of an option where 0 means one per core
+static unsigned thread_count(unsigned requested){
+    return requested ? requested : std::max(1u, std::thread::hardware_concurrency());
+}
+
+//Workers with a queue each: a worker runs the tasks of its own queue from the front, and when it
+//is empty, steals from the back of the others'. The tasks left when the pool goes are still run.
+//The thread that submits can lend a hand with run_one(), a pool without workers relies on it.
+class WorkPool final {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkPool(unsigned threads){
+        for (unsigned i = 0; i < std::max(threads, 1u); ++i) m_queues.emplace_back(new Queue);
+        for (unsigned i = 0; i < threads; ++i) m_threads.emplace_back(&WorkPool::run, this, i);
+    }
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+    ~WorkPool(){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &thread : m_threads) thread.join();
+    }
+
+    unsigned size() const {return static_cast<unsigned>(m_threads.size());}
+
+    //queue the task on worker `hint` modulo the size, any idle worker may take it from there
+    void submit(Task task, size_t hint){
+        Queue &queue = *m_queues[hint % m_queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_pending;
+        }
+        m_wake.notify_one();
+    }
 
+    //run a task on the calling thread, from the front of queue `hint` or stolen from another one.
+    //False when they are all empty.
+    bool run_one(size_t hint){
+        Task task;
+        if (!take(hint % m_queues.size(), task)) return false;
+        task();
+        return true;
+    }
+
+private:
+    struct Queue{
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool take(size_t self, Task &task){
+        for (size_t i = 0; i < m_queues.size(); ++i){
+            Queue &queue = *m_queues[(self + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) continue;
+            if (i == 0){
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void run(size_t self){
+        Task task;
+        while (true){
+            if (take(self, task)){
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]{ return m_stop || m_pending.load(std::memory_order_relaxed); });
+            if (m_stop && !m_pending.load(std::memory_order_relaxed)) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex; //where the idle workers wait, m_pending only grows under it
+    std::condition_variable m_wake;
+    std::atomic<size_t> m_pending{0};
+    bool m_stop = false;
+};
+
+//tasks of one call on a WorkPool: how many are in flight, whether to stop early, and the first
+//exception thrown by one of them, for the caller to rethrow
+struct TaskGroup{
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t in_flight = 0;
+    std::atomic<bool> stop{false};
+    std::exception_ptr error;
+
+    template<typename F>
+    void submit(WorkPool &pool, size_t hint, F task){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++in_flight;
+        }
+        pool.submit([this, task]{
+            std::exception_ptr thrown;
+            try { task(); } catch (...) { thrown = std::current_exception(); }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (thrown){
+                if (!error) error = thrown;
+                stop = true;
+            }
+            --in_flight;
+            changed.notify_all();
+        }, hint);
+    }
+    void wait(){
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]{ return !in_flight; });
+    }
+};
+
+//however the caller is left, the tasks that point into its frame are done first
+class TaskGroupGuard final {
+public:
+    explicit TaskGroupGuard(TaskGroup &group) : m_group(group) {}
+    ~TaskGroupGuard(){
+        m_group.stop = true;
+        m_group.wait();
+    }
+private:
+    TaskGroup &m_group;
+};
+
+//NDJSON
+
+//the first line boundary at least `size` bytes after begin
+static const char *ndjson_chunk_end(const char *begin, const char *end, size_t size){
+    if (static_cast<size_t>(end - begin) <= size) return end;
+    const char *newline = static_cast<const char *>(memchr(begin + size, '\n', static_cast<size_t>(end - begin - size)));
+    return newline ? newline + 1 : end;
 }
 
+//hand the records of the lines in [begin, end) to deliver, until it returns false or the run stops.
+//The records of a chunk share their keys. Lines are copied first, as the parser expects a '\0' after the text.
+template<typename F>
+static void parse_ndjson_lines(const char *base, const char *begin, const char *end, const std::atomic<bool> &stop, F deliver){
+    KeyTable keys;
+    string line, err;
+    for (const char *p = begin; p < end && !stop.load(std::memory_order_relaxed); ){
+        const char *newline = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!newline) newline = end;
+        const char *first = p;
+        while (first < newline && is_space(*first)) ++first;
+        if (first != newline){
+            //the '\r' of a "\r\n" is part of the line end, not of the document
+            line.assign(p, newline[-1] == '\r' ? newline - 1 : newline);
+            err.clear();
+            NdjsonRecord record{static_cast<size_t>(p - base), Json::parse(line, err, keys), string()};
+            record.error.swap(err);
+            if (!deliver(record)) return;
+        }
+        p = newline + 1;
+    }
+}
+
+//Reading in input order: the chunks of a bounded window are parsed in any order. The worker of the
+//oldest chunk hands its records to the callback as it goes, the other chunks are kept until the ones
+//before them are delivered, by whichever worker completes the gap. The callback sees the records one
+//at a time and in order, and most of them are freed right after it by the thread that built them,
+//while they are still in its cache.
+class NdjsonSequencer final {
+public:
+    NdjsonSequencer(WorkPool &pool, const NdjsonOptions &options, const char *begin, const char *end,
+                    const NdjsonReader::Callback &callback)
+        : m_pool(pool), m_options(options), m_begin(begin), m_end(end), m_callback(callback),
+          m_limit(4 * static_cast<size_t>(pool.size())), m_next(begin) {}
+
+    bool read(){
+        {
+            TaskGroupGuard guard(m_run);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                fill();
+            }
+            m_run.wait();
+        }
+        if (m_run.error) std::rethrow_exception(m_run.error);
+        return !m_stopped;
+    }
+
+private:
+    struct Chunk{
+        vector<NdjsonRecord> records;
+        bool done = false;
+    };
+
+    WorkPool &m_pool;
+    const NdjsonOptions &m_options;
+    const char *m_begin, *m_end;
+    const NdjsonReader::Callback &m_callback;
+    const size_t m_limit;
+
+    std::mutex m_mutex; //guards the fields below
+    std::deque<Chunk> m_window; //only grows at the back and shrinks at the front, the chunks don't move
+    const char *m_next;
+    size_t m_submitted = 0;
+    bool m_delivering = false;
+    bool m_stopped = false; //by the callback
+    TaskGroup m_run;
+
+    //queue chunks until the window is full, with the mutex held
+    void fill(){
+        while (m_next < m_end && m_window.size() < m_limit){
+            const char *begin = m_next, *end = ndjson_chunk_end(m_next, m_end, m_options.chunk_size);
+            m_next = end;
+            m_window.emplace_back();
+            Chunk *chunk = &m_window.back();
+            m_run.submit(m_pool, m_submitted++, [this, chunk, begin, end]{ parse(*chunk, begin, end); });
+        }
+    }
+
+    bool deliver(NdjsonRecord &record){
+        if (m_callback(record)) return true;
+        m_stopped = m_run.stop = true;
+        return false;
+    }
+
+    void parse(Chunk &chunk, const char *begin, const char *end){
+        //the oldest chunk goes to the callback as it is parsed, the others wait in the window
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool streaming = !m_delivering && &m_window.front() == &chunk;
+        m_delivering = m_delivering || streaming;
+        lock.unlock();
+        vector<NdjsonRecord> records;
+        if (streaming)
+            parse_ndjson_lines(m_begin, begin, end, m_run.stop, [this](NdjsonRecord &record){ return deliver(record); });
+        else
+            parse_ndjson_lines(m_begin, begin, end, m_run.stop, [&records](NdjsonRecord &record){
+                records.push_back(std::move(record));
+                return true;
+            });
+        lock.lock();
+        chunk.records = std::move(records);
+        chunk.done = true;
+        //whoever is delivering sees this chunk before it stops
+        if (!streaming){
+            if (m_delivering) return;
+            m_delivering = true;
+        }
+        while (!m_window.empty() && m_window.front().done && !m_run.stop){
+            records = std::move(m_window.front().records);
+            m_window.pop_front();
+            fill();
+            lock.unlock();
+            for (auto &record : records)
+                if (!deliver(record)) break;
+            records.clear();
+            lock.lock();
+        }
+        m_delivering = false;
+    }
+};
+
+//every chunk queued at once, the workers call back themselves
+static bool read_ndjson_unordered(WorkPool &pool, const NdjsonOptions &options, const char *begin, const char *end,
+                                  const NdjsonReader::Callback &callback){
+    TaskGroup run;
+    std::atomic<bool> stopped{false}; //by the callback
+    {
+        TaskGroupGuard guard(run);
+        size_t submitted = 0;
+        for (const char *chunk_begin = begin; chunk_begin < end; ){
+            const char *chunk_end = ndjson_chunk_end(chunk_begin, end, options.chunk_size);
+            run.submit(pool, submitted++, [&run, &stopped, &callback, begin, chunk_begin, chunk_end]{
+                parse_ndjson_lines(begin, chunk_begin, chunk_end, run.stop, [&run, &stopped, &callback](NdjsonRecord &record){
+                    if (callback(record)) return true;
+                    stopped = run.stop = true;
+                    return false;
+                });
+            });
+            chunk_begin = chunk_end;
+        }
+        run.wait();
+    }
+    if (run.error) std::rethrow_exception(run.error);
+    return !stopped;
+}
+
+NdjsonReader::NdjsonReader(const NdjsonOptions &options)
+    : m_options(options), m_pool(new WorkPool(thread_count(options.threads))){
+    if (!m_options.chunk_size) m_options.chunk_size = 1;
+}
+
+NdjsonReader::~NdjsonReader() = default;
+
+unsigned NdjsonReader::threads() const{
+    return m_pool->size();
+}
+
+bool NdjsonReader::read(const char *data, size_t size, const Callback &callback){
+    if (m_options.ordered)
+        return NdjsonSequencer(*m_pool, m_options, data, data + size, callback).read();
+    return read_ndjson_unordered(*m_pool, m_options, data, data + size, callback);
+}
+
+bool NdjsonReader::read_file(const string &path, string &err, const Callback &callback){
+    MappedFile file;
+    if (!file.open(path, err))
+        return false;
+    return read(file.begin(), static_cast<size_t>(file.end() - file.begin()), callback);
+}
+
+
+//Parallel parsing
+//where a top-level array opened at buf[open] is cut: the first comma between two of its elements past
+//every multiple of `step`, and the position of its closing bracket. False when the pre-scan finds the
+//text unbalanced, the parser is then left to tell what is wrong.
+static bool split_array(const char *buf, size_t len, size_t open, size_t step, vector<size_t> &cuts, size_t &close){
+    StructuralIndexer indexer;
+    size_t depth = 0, target = open + step;
+    bool closed = false;
+    bool complete = indexer.operators(buf + open, len - open, [&](size_t at){
+        at += open;
+        switch (buf[at]){
+            case '[': case '{':
+                ++depth;
+                return true;
+            case ']': case '}':
+                if (--depth) return true;
+                close = at;
+                closed = true;
+                return false;
+            case ',':
+                if (depth == 1 && at >= target){
+                    cuts.push_back(at);
+                    target = at + step;
+                }
+                return true;
+            default:
+                return true;
+        }
+    });
+    return complete && closed && buf[close] == ']';
+}
+
+//elements of the array in buf[begin, end), where end is a cut or the closing bracket. They must fill the
+//range exactly, so that the ranges put back together are the array; false when they don't.
+static bool parse_array_range(const char *buf, size_t len, size_t begin, size_t end, bool whole, Arena *arena,
+                              vector<Json> &out){
+    jParser p(buf, buf + len, arena);
+    p.max_depth(ParseOptions().max_depth - 1); //inside the top-level array
+    p.seek(buf + begin);
+    p.skipSpace();
+    if (whole && p.position() == buf + end) return true; //[]
+    while (true){
+        out.push_back(p.parse());
+        if (p.failed()) return false;
+        p.skipSpace();
+        if (p.position() == buf + end) return true;
+        if (p.position() > buf + end || p.get_pos() != ',') return false;
+        p.seek(p.position() + 1);
+        p.skipSpace();
+    }
+}
+
+Json Json::parse_parallel(const string &in, string &err, unsigned threads) noexcept{
+    //ranges below this size are not worth a task
+    static const size_t min_range = 64 * 1024;
+    const char *buf = in.c_str();
+    size_t len = in.size(), open = 0, close = 0;
+    while (open < len && is_space(buf[open])) ++open;
+    if (open == len || buf[open] != '[')
+        return parse(in, err);
+    try {
+        //the calling thread is one of them, the others use malloc arenas of their own, that have to
+        //grow into memory the process may already hold
+        threads = thread_count(threads);
+        WorkPool pool(threads - 1);
+        //a few ranges per thread, for the stealing to even out their costs
+        size_t ranges = std::max<size_t>(1, std::min<size_t>(4 * static_cast<size_t>(threads), len / min_range));
+        vector<size_t> cuts;
+        if (!split_array(buf, len, open, len / ranges, cuts, close))
+            return parse(in, err);
+        size_t rest = close + 1;
+        while (rest < len && is_space(buf[rest])) ++rest;
+        if (rest != len)
+            return parse(in, err);
+
+        //the arenas go last, after the nodes that may still be in the parts
+        vector<std::shared_ptr<Arena>> arenas(cuts.size() + 1);
+        vector<vector<Json>> parts(cuts.size() + 1);
+        std::atomic<bool> malformed{false};
+        TaskGroup group;
+        {
+            TaskGroupGuard guard(group);
+            for (size_t i = 0; i < parts.size(); ++i){
+                size_t begin = i ? cuts[i - 1] + 1 : open + 1, end = i < cuts.size() ? cuts[i] : close;
+                group.submit(pool, i, [&, i, begin, end]{
+                    if (group.stop) return;
+                    arenas[i] = std::make_shared<Arena>(1 << 20);
+                    if (!parse_array_range(buf, len, begin, end, parts.size() == 1, arenas[i].get(), parts[i])){
+                        malformed = true;
+                        group.stop = true;
+                    }
+                });
+            }
+            while (pool.run_one(0)) {}
+            group.wait();
+        }
+        //the serial parser tells what is wrong
+        if (group.error || malformed)
+            return parse(in, err);
+
+        size_t total = 0;
+        for (auto &part : parts) total += part.size();
+        array values;
+        values.reserve(total);
+        for (size_t i = 0; i < parts.size(); ++i){
+            for (auto &value : parts[i]) values.push_back(std::move(value));
+            //from now on the nodes keep their arena alive, the last one to go releases it
+            if (arenas[i]->m_nodes.load(std::memory_order_acquire))
+                arenas[i]->m_self = arenas[i];
+        }
+        return Json(std::move(values));
+    } catch (std::exception &) {
+        //no threads to be had
+        return parse(in, err);
+    }
+}
 
 }
@@ -4,10 +4,359 @@
 #include <vector>
 #include <memory>
 #include <map>
+#include <cstddef>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+#include <type_traits>
+#include <cstdio>
 
 namespace lxjson{
 
-class JsonValue;
+class Arena;
+class JsonTape;
+class KeyTable;
+class JsonSink;
+class JsonWriter;
+class WorkPool;
+struct ParseBuffers;
+struct JsonNode;
+
+//the characters of a string value, without a copy; valid as long as the value
+struct StringView {
+    const char *data;
+    size_t size;
+
+    std::string str() const {return std::string(data, size);}
+};
+
+//FNV-1a, the hash of object keys
+inline size_t key_hash(const char *data, size_t size){
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i){
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h);
+}
+inline size_t key_hash(const std::string &key) {return key_hash(key.data(), key.size());}
+inline size_t key_hash(const char *key) {return key_hash(key, strlen(key));}
+
+//Key of Json::object when LXJSON_FLAT_OBJECT is defined: an immutable string shared by reference
+//count, its hash computed once. The keys interned by a KeyTable exist once per table, so a lookup
+//with one of them usually succeeds on the address without looking at the characters.
+class JsonKey {
+public:
+    JsonKey() : JsonKey(std::string()) {}
+    JsonKey(const std::string &key) : m_rep(new Rep(key)) {}
+    JsonKey(std::string &&key) : m_rep(new Rep(std::move(key))) {}
+    JsonKey(const char *key) : m_rep(new Rep(key)) {}
+    JsonKey(const JsonKey &rhs) noexcept : m_rep(rhs.m_rep) {
+        m_rep->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    JsonKey(JsonKey &&rhs) noexcept : m_rep(rhs.m_rep) {rhs.m_rep = nullptr;}
+    ~JsonKey() {release(m_rep);}
+    JsonKey &operator=(JsonKey rhs) noexcept {
+        std::swap(m_rep, rhs.m_rep);
+        return *this;
+    }
+
+    const std::string &str() const {return m_rep->value;}
+    operator const std::string &() const {return m_rep->value;}
+    size_t hash() const {return m_rep->hash;}
+
+    bool operator==(const JsonKey &rhs) const {
+        return m_rep == rhs.m_rep || (m_rep->hash == rhs.m_rep->hash && m_rep->value == rhs.m_rep->value);
+    }
+    bool operator!=(const JsonKey &rhs) const {return !(*this == rhs);}
+    bool operator<(const JsonKey &rhs) const {return m_rep->value < rhs.m_rep->value;}
+    bool operator==(const std::string &rhs) const {return m_rep->value == rhs;}
+    bool operator==(const char *rhs) const {return m_rep->value == rhs;}
+
+private:
+    friend class KeyTable;
+
+    struct Rep{
+        template<typename S>
+        explicit Rep(S &&key) : refs(1), value(std::forward<S>(key)) {hash = key_hash(value);}
+
+        std::atomic<size_t> refs;
+        size_t hash;
+        std::string value;
+    };
+    //takes over a reference
+    explicit JsonKey(Rep *rep) noexcept : m_rep(rep) {}
+    static void release(Rep *rep) noexcept {
+        if (rep && rep->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete rep;
+    }
+
+    Rep *m_rep;
+};
+inline size_t key_hash(const JsonKey &key) {return key.hash();}
+
+//Interning table for object keys: Json::parse(in, err, keys) stores every key once in it, and
+//the documents parsed with the same table share their keys. A `shared` table can be used by
+//several threads at once. The keys stay valid when the table is gone.
+class KeyTable final {
+public:
+    explicit KeyTable(bool shared = false) : m_shared(shared) {}
+    ~KeyTable();
+    KeyTable(const KeyTable&) = delete;
+    KeyTable& operator=(const KeyTable&) = delete;
+
+    JsonKey intern(const char *data, size_t size);
+    JsonKey intern(const std::string &key) {return intern(key.data(), key.size());}
+    //number of distinct keys
+    size_t size() const;
+
+private:
+    //a shared table spreads the keys, and the contention, over several locked shards
+    static const size_t shard_count = 16;
+    struct Shard{
+        std::mutex mutex;
+        std::vector<JsonKey::Rep *> slots; //open addressing, a power of two at least twice the size
+        size_t size = 0;
+    };
+    Shard m_shards[shard_count];
+    bool m_shared;
+};
+
+//Flat object storage, Json::object when LXJSON_FLAT_OBJECT is defined (for the library and its
+//users alike). The entries sit in one vector in insertion order; small objects are searched
+//linearly, bigger ones also get an open-addressing hash index. It keeps the part of the std::map
+//interface that is used on Json::object, iteration over (key, value) pairs included; equality
+//and ordering don't depend on the order of the entries, like for a std::map.
+template<typename T, typename Key = std::string>
+class FlatObject {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = size_t;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    //objects up to this size have no index
+    static const size_t index_threshold = 8;
+
+    FlatObject() = default;
+    FlatObject(std::initializer_list<value_type> values){
+        for (auto &value : values) emplace(value.first, value.second);
+    }
+    template<typename It>
+    FlatObject(It first, It last){
+        for (; first != last; ++first) emplace(first->first, first->second);
+    }
+
+    iterator begin() {return m_entries.begin();}
+    iterator end() {return m_entries.end();}
+    const_iterator begin() const {return m_entries.begin();}
+    const_iterator end() const {return m_entries.end();}
+    size_t size() const {return m_entries.size();}
+    bool empty() const {return m_entries.empty();}
+    void reserve(size_t n) {m_entries.reserve(n);}
+    void clear(){
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    //K: Key, or a string type Key can be compared with
+    template<typename K>
+    iterator find(const K &key){
+        size_t i = lookup(key, key_hash(key));
+        return i == npos ? end() : begin() + i;
+    }
+    template<typename K>
+    const_iterator find(const K &key) const{
+        size_t i = lookup(key, key_hash(key));
+        return i == npos ? end() : begin() + i;
+    }
+    template<typename K>
+    size_t count(const K &key) const {return find(key) != end();}
+    template<typename K>
+    T &at(const K &key){
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("FlatObject::at");
+        return it->second;
+    }
+    template<typename K>
+    const T &at(const K &key) const{
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("FlatObject::at");
+        return it->second;
+    }
+    T &operator[](const Key &key){
+        iterator it = find(key);
+        return it != end() ? it->second : emplace(key, T()).first->second;
+    }
+
+    //like std::map, an existing key keeps its value
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K &&key, Args&&... args){
+        value_type entry(std::forward<K>(key), T(std::forward<Args>(args)...));
+        size_t h = key_hash(entry.first);
+        size_t i = lookup(entry.first, h);
+        if (i != npos) return std::make_pair(begin() + i, false);
+        m_entries.push_back(std::move(entry));
+        if (!m_index.empty() && m_index.size() >= 2 * m_entries.size())
+            index_insert(h, m_entries.size() - 1);
+        else if (m_entries.size() > index_threshold)
+            rebuild_index();
+        return std::make_pair(end() - 1, true);
+    }
+    std::pair<iterator, bool> insert(const value_type &value) {return emplace(value.first, value.second);}
+
+    //keeps the order of the other entries
+    iterator erase(const_iterator pos){
+        iterator next = m_entries.erase(begin() + (pos - m_entries.cbegin()));
+        if (m_entries.size() > index_threshold) rebuild_index();
+        else m_index.clear();
+        return next;
+    }
+    template<typename K>
+    size_t erase(const K &key){
+        const_iterator it = find(key);
+        if (it == end()) return 0;
+        erase(it);
+        return 1;
+    }
+
+    bool operator==(const FlatObject &rhs) const{
+        if (size() != rhs.size()) return false;
+        for (auto &entry : m_entries){
+            const_iterator it = rhs.find(entry.first);
+            if (it == rhs.end() || !(it->second == entry.second)) return false;
+        }
+        return true;
+    }
+    bool operator!=(const FlatObject &rhs) const {return !(*this == rhs);}
+    //the order of std::map: the entries sorted by key, compared lexicographically
+    bool operator<(const FlatObject &rhs) const{
+        std::vector<const value_type *> lhs_sorted = sorted(), rhs_sorted = rhs.sorted();
+        return std::lexicographical_compare(lhs_sorted.begin(), lhs_sorted.end(), rhs_sorted.begin(), rhs_sorted.end(),
+                                            [](const value_type *a, const value_type *b){return *a < *b;});
+    }
+    bool operator>(const FlatObject &rhs) const {return rhs < *this;}
+    bool operator<=(const FlatObject &rhs) const {return !(rhs < *this);}
+    bool operator>=(const FlatObject &rhs) const {return !(*this < rhs);}
+
+private:
+    static const size_t npos = static_cast<size_t>(-1);
+    static const uint32_t empty_slot = UINT32_MAX;
+    struct Slot{
+        uint32_t hash;
+        uint32_t index;
+    };
+
+    std::vector<value_type> m_entries;
+    std::vector<Slot> m_index; //empty, or a power of two at least twice the number of entries
+
+    template<typename K>
+    size_t lookup(const K &key, size_t h) const{
+        if (m_index.empty()){
+            for (size_t i = 0; i < m_entries.size(); ++i)
+                if (m_entries[i].first == key) return i;
+            return npos;
+        }
+        size_t mask = m_index.size() - 1;
+        for (size_t s = h & mask; ; s = (s + 1) & mask){
+            const Slot &slot = m_index[s];
+            if (slot.index == empty_slot) return npos;
+            if (slot.hash == static_cast<uint32_t>(h) && m_entries[slot.index].first == key) return slot.index;
+        }
+    }
+    void index_insert(size_t h, size_t index){
+        size_t mask = m_index.size() - 1, s = h & mask;
+        while (m_index[s].index != empty_slot) s = (s + 1) & mask;
+        m_index[s] = Slot{static_cast<uint32_t>(h), static_cast<uint32_t>(index)};
+    }
+    void rebuild_index(){
+        size_t capacity = 2 * index_threshold;
+        while (capacity < 2 * m_entries.size()) capacity *= 2;
+        m_index.assign(capacity, Slot{0, empty_slot});
+        for (size_t i = 0; i < m_entries.size(); ++i)
+            index_insert(key_hash(m_entries[i].first), i);
+    }
+    std::vector<const value_type *> sorted() const{
+        std::vector<const value_type *> out;
+        out.reserve(m_entries.size());
+        for (auto &entry : m_entries) out.push_back(&entry);
+        std::sort(out.begin(), out.end(), [](const value_type *a, const value_type *b){return a->first < b->first;});
+        return out;
+    }
+};
+
+//how Json::serialize writes the text
+struct SerializeOptions {
+    //DEFAULT separates with ", " and ": " on one line, COMPACT writes no whitespace at all, PRETTY
+    //puts every member and element on a line of its own, indented by `indent` spaces per level
+    enum class Style : unsigned char {
+        DEFAULT,
+        COMPACT,
+        PRETTY
+    };
+    Style style = Style::DEFAULT;
+    unsigned indent = 4;
+    //write the keys in byte order, rather than in the order of the object (std::map is sorted anyway)
+    bool sort_keys = false;
+
+    //characters above ASCII: copied as they are, copied after a UTF-8 check, or written as \uXXXX
+    //escapes (a surrogate pair above U+FFFF). The last two throw std::runtime_error on invalid UTF-8.
+    enum class Unicode : unsigned char {
+        PASS,
+        VALIDATE,
+        ESCAPE
+    };
+    Unicode unicode = Unicode::PASS;
+};
+
+//limits of Json::parse, the overloads without options use the defaults
+struct ParseOptions {
+    //the containers nested deeper are an error. The parser keeps them on a stack of its own rather
+    //than on the call stack, but a tree is destroyed and serialized recursively.
+    size_t max_depth = 512;
+    //check that the strings are well-formed UTF-8: nothing truncated, no overlong form, surrogate or
+    //code point above U+10FFFF. Otherwise their bytes are taken as they are.
+    bool validate_utf8 = false;
+};
+
+//what went wrong in a failed Json::parse, and where. The kinds are meant for code, message() for people.
+struct ParseStatus {
+    enum class Error : unsigned char {
+        NONE,
+        UNEXPECTED_END,           //the text stops before the value is complete, or holds none
+        INVALID_VALUE,            //no value starts with this character
+        INVALID_LITERAL,          //starts like null, true or false but is not one of them
+        INVALID_NUMBER,           //leading zeros, or no digit after the '-', '.' or exponent
+        NUMBER_OUT_OF_RANGE,      //too large for a double
+        UNTERMINATED_STRING,
+        INVALID_STRING_CHARACTER, //a control character in a string
+        INVALID_ESCAPE,           //a backslash followed by something else than "\/bfnrtu
+        INVALID_UNICODE_ESCAPE,   //\u without 4 hex digits, or a broken surrogate pair
+        EXPECTED_COMMA_OR_BRACKET,
+        EXPECTED_COMMA_OR_BRACE,
+        EXPECTED_KEY,
+        EXPECTED_COLON,
+        TRAILING_CHARACTERS,      //something else after the value
+        TOO_DEEP,                 //more nested containers than ParseOptions::max_depth
+        INVALID_UTF8              //with ParseOptions::validate_utf8, a string that is not well-formed UTF-8
+    };
+    Error error = Error::NONE;
+    size_t offset = 0; //of the offending byte in the text
+    size_t line = 0;   //from 1, lines end with '\n'
+    size_t column = 0; //from 1, in bytes
+
+    bool ok() const {return error == Error::NONE;}
+    //the message of Json::parse(in, err): what, then where
+    std::string message() const;
+};
 
 class Json final {
 public:
@@ -22,16 +371,42 @@ public:
     };
 
 
+    //parser implementations: the classic recursive descent one, or the simdjson-style
+    //structural index + tape (see JsonTape), converted to a tree afterwards.
+    //LAZY validates the whole text but builds nothing: the document keeps a copy of the text, and
+    //every array or object is built, one level at a time, the first time it is accessed.
+    //PARALLEL is parse_parallel() with a thread per core.
+    enum class ParseEngine {
+        RECURSIVE_DESCENT,
+        TWO_STAGE,
+        LAZY,
+        PARALLEL
+    };
+
+    //where parse_file keeps the string values: copied into the nodes, or, for the ones without
+    //escapes, as views into the mapped file, which then lives as long as the document
+    enum class StringStorage {
+        COPY,
+        VIEW
+    };
+
     //Prefer alias declarations to typedefs
     using array = std::vector<Json>;
+#ifdef LXJSON_FLAT_OBJECT
+    using object = FlatObject<Json, JsonKey>;
+#else
     using object = std::map<std::string, Json>;
+#endif
 
     //constructors
-    explicit Json() noexcept;
-    explicit Json(std::nullptr_t) noexcept;//nullptr is a C++ keyword literal of type std::nullptr_t
-    explicit Json(double);
-    explicit Json(int);
-    explicit Json(bool);
+    explicit Json() noexcept : m_kind(Kind::K_NULL), m_node(nullptr) {}
+    explicit Json(std::nullptr_t) noexcept : m_kind(Kind::K_NULL), m_node(nullptr) {}//nullptr is a C++ keyword literal of type std::nullptr_t
+    explicit Json(double value) noexcept : m_kind(Kind::K_DOUBLE), m_double(value) {}
+    explicit Json(int value) noexcept : m_kind(Kind::K_INT), m_int(value) {}
+    explicit Json(int64_t value) noexcept : m_kind(Kind::K_INT), m_int(value) {}
+    explicit Json(uint64_t value) noexcept
+        : m_kind(value > static_cast<uint64_t>(INT64_MAX) ? Kind::K_UINT : Kind::K_INT), m_uint(value) {}
+    explicit Json(bool value) noexcept : m_kind(Kind::K_BOOL), m_bool(value) {}
     explicit Json(const std::string&);
     explicit Json(std::string&&);
     explicit Json(const char*);
@@ -40,14 +415,24 @@ public:
     explicit Json(const object &);
     explicit Json(object &&);
 
-    //copy constructor
-    Json(const Json&);
+    //copy constructor, shares the value instead of copying it, see the edits below
+    Json(const Json& rhs) noexcept : m_kind(rhs.m_kind), m_node(rhs.m_node) {
+        if (is_node()) retain();
+    }
     //move constructor
-    Json(Json&&) noexcept;
+    Json(Json&& rhs) noexcept : m_kind(rhs.m_kind), m_node(rhs.m_node) {
+        rhs.m_kind = Kind::K_NULL;
+    }
 
-    ~Json();
+    ~Json() {
+        if (is_node()) release();
+    }
 
-    Json& operator=(Json);
+    Json& operator=(Json rhs) noexcept {
+        std::swap(m_kind, rhs.m_kind);
+        std::swap(m_node, rhs.m_node);
+        return *this;
+    }
 
     bool operator==(const Json&) const;
     bool operator>(const Json&) const;
@@ -57,22 +442,39 @@ public:
     bool operator<=(const Json& rhs) const {return !(*this>rhs);}
 
     //Type
-    JsonType type() const;
-    bool is_null() const;
-    bool is_number() const; 
-    bool is_bool() const;
-    bool is_string() const;
-    bool is_array() const;
-    bool is_object() const;
-
-    //number-type
+    JsonType type() const {
+        switch (m_kind){
+            case Kind::K_NULL:   return JsonType::T_NULL;
+            case Kind::K_BOOL:   return JsonType::T_BOOL;
+            case Kind::K_INT:
+            case Kind::K_UINT:
+            case Kind::K_DOUBLE: return JsonType::T_NUMBER;
+            case Kind::K_STRING:
+            case Kind::K_STRING_VIEW: return JsonType::T_STRING;
+            case Kind::K_ARRAY:
+            case Kind::K_LAZY_ARRAY: return JsonType::T_ARRAY;
+            default:             return JsonType::T_OBJECT;
+        }
+    }
+    bool is_null() const    {return m_kind == Kind::K_NULL;}
+    bool is_number() const  {return m_kind == Kind::K_INT || m_kind == Kind::K_UINT || m_kind == Kind::K_DOUBLE;}
+    bool is_bool() const    {return m_kind == Kind::K_BOOL;}
+    bool is_string() const  {return m_kind == Kind::K_STRING || m_kind == Kind::K_STRING_VIEW;}
+    bool is_array() const   {return m_kind == Kind::K_ARRAY || m_kind == Kind::K_LAZY_ARRAY;}
+    bool is_object() const  {return m_kind == Kind::K_OBJECT || m_kind == Kind::K_LAZY_OBJECT;}
+
+    //number-type, integers are kept exactly when they are parsed or built as integers.
+    //Out of range values are converted like a static_cast.
     int int_value() const;
+    int64_t int64_value() const;
+    uint64_t uint64_value() const;
     double double_value() const;
     //bool-value
     bool bool_value() const;
-    //string-type
+    //string-type, a view into a mapped file is copied into a std::string the first time
     const std::string& string_value() const;
-    //array-type
+    StringView string_view() const;
+    //array-type, the containers of a lazily parsed document are built on the first call
     const array& array_value() const;
     //object-type
     const object& object_value() const;
@@ -80,54 +482,472 @@ public:
     //return arr[i] if this is an array
     const Json& operator[](size_t i) const;
     //return obj[key] if this is an object
-    const Json& operator[](const std::string key) const;
+    const Json& operator[](const std::string &key) const;
+    //with an interned key, the lookup compares addresses before characters
+    //(a template, so that string literals keep going to the std::string overload)
+    template<typename K, typename = typename std::enable_if<std::is_same<K, JsonKey>::value>::type>
+    const Json& operator[](const K &key) const {return find_key(key);}
+
+    //Edit, copy-on-write: a string or container owned by this value alone is changed in place, a
+    //shared one is copied first, one level deep, the copy sharing the children. Through nested
+    //edit(), doc.edit("a").edit("b") = x copies only the shared containers on the path to "b", and
+    //the other owners keep seeing the old tree. operator[] stays a read, which never copies.
+    //A reference returned here is valid until this value is copied or edited again. A null value
+    //becomes an object or an array on its first edit, any other type throws std::runtime_error.
+    //arr[i] for writing, std::out_of_range past the end
+    Json& edit(size_t i);
+    //obj[key] for writing, a new key is inserted with a null value first, like std::map::operator[]
+    Json& edit(const std::string &key);
+    template<typename K, typename = typename std::enable_if<std::is_same<K, JsonKey>::value>::type>
+    Json& edit(const K &key) {return edit_key(key);}
+    //insert or replace the member
+    void set(const std::string &key, Json value) {edit(key) = std::move(value);}
+    void push_back(Json value);
+    //remove the member, false when there is none
+    bool erase(const std::string &key);
+    //remove arr[i], the elements after it move down, std::out_of_range past the end
+    void erase(size_t i);
 
     //Serialize
-    void serialize(std::string &out) const;
-    std::string serialize() const{
+    //append to out, which grows once, to a bound computed first
+    void serialize(std::string &out, const SerializeOptions &options = SerializeOptions()) const;
+    std::string serialize(const SerializeOptions &options = SerializeOptions()) const{
         std::string out;
-        serialize(out);
+        serialize(out, options);
         return out;
     }
+    //hand the text to the sink in blocks, the whole document is never held in memory.
+    //false when the sink failed
+    bool serialize(JsonSink &sink, const SerializeOptions &options = SerializeOptions()) const;
+    //number of characters written by serialize()
+    size_t serialized_size(const SerializeOptions &options = SerializeOptions()) const;
+
+    //CBOR (RFC 8949), the same values without the text: integers and doubles in binary, strings and
+    //containers prefixed by their length. A double that a float holds exactly takes 4 bytes, not 8.
+    void to_cbor(std::string &out) const;
+    std::string to_cbor() const{
+        std::string out;
+        to_cbor(out);
+        return out;
+    }
+    //one CBOR item that covers the whole input, read in a single pass. Indefinite lengths and tags
+    //are accepted; byte strings, and the simple values that are not false, true, null or undefined, are not
+    static Json from_cbor(const char *data, size_t size, std::string &err) noexcept;
+    static Json from_cbor(const std::string &in, std::string &err) noexcept{
+        return from_cbor(in.data(), in.size(), err);
+    }
 
+    //parse the c++ string, on error the null value is returned and `status` tells why and where.
+    //A malformed input is given up where it goes wrong, with no exception thrown even internally.
+    static Json parse(const std::string &in, ParseStatus &status, const ParseOptions &options = ParseOptions()) noexcept;
     //parse the c++ string, if error happens, storage the message in the err
     static Json parse(const std::string &in, std::string& err) noexcept;
-    static Json parse(const char* in, std::string& err){
-        if (in)
-            return parse(std::string(in), err);
-        else{
-            err = "null input";
-            return Json(nullptr);
+    static Json parse(const char* in, std::string& err) noexcept;
+    //parse into a caller-supplied arena, which must outlive the returned document and all its copies
+    static Json parse(const std::string &in, std::string& err, Arena& arena) noexcept;
+    //parse into an arena owned by the document, it is released together with the last node
+    static Json parse(const std::string &in, std::string& err, std::shared_ptr<Arena> arena) noexcept;
+    static Json parse(const std::string &in, std::string& err, ParseEngine engine) noexcept;
+    //intern the object keys in `keys`, shared by the documents parsed with it. Without this, keys are
+    //interned per document. Only FlatObject can share its keys: with std::map as Json::object,
+    //every entry owns a copy and the table is left unused.
+    static Json parse(const std::string &in, std::string& err, KeyTable &keys) noexcept;
+    //a top-level array is cut into ranges of elements by a pre-scan of its structure, and the ranges
+    //are parsed on `threads` threads (0 for one per core), each into an arena of its own, then joined.
+    //Any other document is parsed serially. An invalid one is parsed again serially, for the same
+    //error as parse().
+    static Json parse_parallel(const std::string &in, std::string& err, unsigned threads = 0) noexcept;
+    //parse one document after another, reusing the parser's buffers, see below
+    class Parser;
+    //parse a file through a read-only mapping instead of a copy in memory
+    static Json parse_file(const std::string &path, std::string& err,
+                           StringStorage storage = StringStorage::COPY) noexcept;
+
+private:
+    friend class jParser;
+    friend class JsonTape;
+    friend class JsonWriter;
+
+    //how the value is stored: scalars inline, strings and containers in a shared JsonNode
+    //K_INT holds every integer that fits in an int64_t, K_UINT only the ones above INT64_MAX.
+    //K_STRING_VIEW points into the buffer a document was parsed from, see StringStorage::VIEW.
+    //K_LAZY_ARRAY and K_LAZY_OBJECT hold the text of a container not built yet, see ParseEngine::LAZY
+    enum class Kind : unsigned char {
+        K_NULL, K_BOOL, K_INT, K_UINT, K_DOUBLE, K_STRING, K_ARRAY, K_OBJECT, K_STRING_VIEW,
+        K_LAZY_ARRAY, K_LAZY_OBJECT
+    };
+
+    Json(Kind kind, JsonNode *node) noexcept : m_kind(kind), m_node(node) {}
+
+    bool is_node() const {return m_kind >= Kind::K_STRING;}
+    template<typename Style>
+    void write(JsonWriter &out, unsigned depth) const;
+    size_t cbor_size() const;
+    unsigned char *write_cbor(unsigned char *p) const;
+    const Json &find_key(const JsonKey &key) const;
+    Json &edit_key(const JsonKey &key);
+    array &edit_array();
+    object &edit_object();
+    static int compare_numbers(const Json &lhs, const Json &rhs);
+    void retain() const noexcept;
+    void release() noexcept;
+    template<typename T, typename... Args>
+    static Json make_node(Kind kind, Arena *arena, Args&&... args);
+
+    //copy-on-write hook for mutations: make sure this Json is the only owner of its node
+    JsonNode *detach();
+
+    Kind m_kind;
+    union {
+        bool m_bool;
+        int64_t m_int;
+        uint64_t m_uint;
+        double m_double;
+        JsonNode *m_node;
+    };
+};
+
+//Json::parse for a run of documents, one after the other: what a parse needs besides its result (the
+//stack of open containers, the buffer of the strings with escapes and, with LXJSON_FLAT_OBJECT, the
+//table of interned keys) is kept for the next document, so that a small message costs little more
+//than the allocations of its own nodes. One parse at a time per parser.
+class Json::Parser final {
+public:
+    //with an `arena_chunk` size, each document gets an arena of its own, released with its last node
+    //as with parse(in, err, std::shared_ptr<Arena>). Once that document is gone, the next one reuses it.
+    explicit Parser(size_t arena_chunk = 0);
+    ~Parser();
+    Parser(const Parser&) = delete;
+    Parser& operator=(const Parser&) = delete;
+
+    //the same results and errors as Json::parse
+    Json parse(const std::string &in, ParseStatus &status, const ParseOptions &options = ParseOptions()) noexcept;
+    Json parse(const std::string &in, std::string &err) noexcept;
+
+private:
+    std::unique_ptr<ParseBuffers> m_buffers;
+    std::shared_ptr<Arena> m_arena; //of the last document
+    size_t m_arena_chunk;
+};
+
+//Compiled query, either an RFC 6901 JSON Pointer ("/a/0/b~1c") or a small path expression:
+//  $                           the root, optional ("a.b" is "$.a.b")
+//  .name  ['name']  ["name"]   an object member
+//  [2]  [-1]                   an array element, negative indexes count from the end
+//  [1:3]  [:-1]  [2:]          a slice of an array, bounds as in Python
+//  .*  [*]                     every member or element
+//It is compiled once, then evaluated against a tree without allocating, or against raw text while
+//parsing it: only the matches are built, everything else is validated and dropped.
+class JsonPath final {
+public:
+    //throws std::runtime_error on a syntax error
+    explicit JsonPath(const std::string &expression);
+    static JsonPath pointer(const std::string &pointer);
+
+    //f(const Json &) for every match, in the order of the containers (sorted keys with std::map)
+    template<typename F>
+    void visit(const Json &root, F f) const {visit(root, 0, f);}
+    //the first match, nullptr when there is none
+    const Json *find(const Json &root) const;
+    std::vector<Json> select(const Json &root) const;
+    //the matches in `text`, in document order, every occurrence of a duplicate key included.
+    //Empty, with the message in err, when the text is not valid JSON.
+    std::vector<Json> select(const std::string &text, std::string &err) const noexcept;
+
+private:
+    friend class jParser;
+
+    struct Step{
+        enum class Kind : unsigned char {
+            NAME, INDEX, WILDCARD, SLICE,
+            NAME_OR_INDEX //a pointer token made of digits, applies to objects and arrays
+        };
+        Kind kind;
+        std::string name;
+        int64_t start; //INDEX, NAME_OR_INDEX and SLICE
+        int64_t stop;  //SLICE, INT64_MAX when open
+
+        bool applies_to_object() const {return kind == Kind::NAME || kind == Kind::WILDCARD || kind == Kind::NAME_OR_INDEX;}
+        //whether range() needs the real length of the array
+        bool needs_length() const {return (kind == Kind::INDEX || kind == Kind::SLICE) && (start < 0 || stop < 0);}
+        //the elements [begin, end) matched in an array of `length` elements
+        void range(size_t length, size_t &begin, size_t &end) const;
+    };
+
+    JsonPath() = default;
+
+    template<typename F>
+    void visit(const Json &value, size_t i, F &f) const{
+        if (i == m_steps.size()){
+            f(value);
+            return;
+        }
+        const Step &step = m_steps[i];
+        if (value.is_object() && step.applies_to_object()){
+            const Json::object &members = value.object_value();
+            if (step.kind == Step::Kind::WILDCARD){
+                for (auto &member : members) visit(member.second, i + 1, f);
+                return;
+            }
+            auto it = members.find(step.name);
+            if (it != members.end()) visit(it->second, i + 1, f);
+        }
+        else if (value.is_array()){
+            const Json::array &items = value.array_value();
+            size_t begin, end;
+            step.range(items.size(), begin, end);
+            for (size_t k = begin; k < end; ++k) visit(items[k], i + 1, f);
         }
     }
 
+    std::vector<Step> m_steps;
+};
+
+//Flat document built by the two-stage parser. Stage one indexes the structural characters of
+//the whole buffer with SIMD, stage two walks that index and writes one 64-bit word per value
+//(two for numbers), with no allocation per node. The tape can be turned into a Json tree,
+//whole or one subtree at a time, and its buffers are reused from one parse to the next.
+class JsonTape final {
+public:
+    //false on error, with the message in err
+    bool parse(const std::string &in, std::string &err) noexcept;
+
+    //number of words, 0 when nothing was parsed
+    size_t size() const {return m_words.size();}
+    //index of the root value, and of the value that follows the one at `index`
+    size_t root() const {return 1;}
+    size_t next(size_t index) const;
+    Json::JsonType type(size_t index) const;
+
+    //build the Json tree of the value at `index`
+    Json to_json(size_t index) const;
+    Json to_json() const {return to_json(root());}
+
 private:
-    std::shared_ptr<JsonValue> jv_ptr;
+    bool build(const char *buf, size_t len, ParseStatus &status);
 
+    std::vector<uint32_t> m_structurals;
+    std::vector<uint64_t> m_words;
+    std::string m_strings;
 };
 
-class JsonValue{
-protected:
-    friend class Json;
-    friend class JsonInt;
-    friend class JsonDouble;
-    virtual Json::JsonType type() const = 0;
-    virtual bool equals(const JsonValue *other) const = 0;
-    virtual bool less(const JsonValue *other) const = 0;
-    virtual void serialize(std::string& out) const = 0;
+//Callbacks of the streaming parser (see JsonStream), in document order. Every one of them returns
+//true to go on, false to stop the parse. Strings and keys are only valid during the call.
+class JsonHandler {
+public:
+    virtual ~JsonHandler() = default;
+
+    virtual bool on_null() {return true;}
+    virtual bool on_bool(bool) {return true;}
+    //integers and doubles, exactly as Json::parse would keep them
+    virtual bool on_number(const Json &) {return true;}
+    virtual bool on_string(const std::string &) {return true;}
+    virtual bool start_object() {return true;}
+    virtual bool key(const std::string &) {return true;}
+    virtual bool end_object() {return true;}
+    virtual bool start_array() {return true;}
+    virtual bool end_array() {return true;}
+};
 
-    virtual double double_value() const;
-    virtual int int_value() const;
-    virtual bool bool_value() const;
-    virtual const std::string &string_value() const;
-    virtual const Json::array &array_value() const;
-    virtual const Json::object &object_value() const;
+//Push parser: the document is fed in chunks of any size, read() from a file for example, and
+//reported to a JsonHandler as it goes, without building a tree. Values are decoded by the same
+//code as Json::parse. Memory use depends on the nesting depth and on the longest string or number,
+//not on the size of the document.
+class JsonStream final {
+public:
+    explicit JsonStream(JsonHandler &handler) : m_handler(handler) {}
 
-    virtual const Json &operator[](size_t i) const;
-    virtual const Json &operator[](const std::string key) const;
+    //false on error, or when the handler stopped the parse, with the message in err
+    bool feed(const char *data, size_t size, std::string &err) noexcept;
+    bool feed(const std::string &data, std::string &err) noexcept {return feed(data.data(), data.size(), err);}
+    //end of the input, false when the document is incomplete
+    bool finish(std::string &err) noexcept;
+    //forget the current document, to parse another one
+    void reset();
+    //the error of Json::parse on the whole input, at the same offset, line and column; NONE when the
+    //handler stopped the parse
+    const ParseStatus &status() const {return m_status;}
 
-    virtual ~JsonValue(){}
-    JsonValue(){}
+private:
+    enum class State : unsigned char {
+        VALUE, ARRAY_START, OBJECT_START, OBJECT_KEY, COLON, AFTER_VALUE, DONE, //between tokens
+        STRING, NUMBER, LITERAL,                                                //inside a token
+        FAILED
+    };
+
+    const char *structural(const char *p);
+    const char *start_value(const char *p);
+    void start_token(const char *p, State state);
+    const char *string_token(const char *p, const char *end);
+    const char *scalar_token(const char *p, const char *end);
+    void end_token(const char *begin, const char *end);
+    void end_container();
+    void value_done();
+    ParseStatus::Error after_value() const;
+    void emit(bool go_on);
+    size_t offset(const char *p) const {return m_offset + static_cast<size_t>(p - m_chunk);}
+    void count_lines(size_t end);
+    [[noreturn]] void fail(ParseStatus::Error error, size_t at);
+
+    JsonHandler &m_handler;
+    State m_state = State::VALUE;
+    bool m_is_key = false;         //the current string is a key
+    bool m_escape = false;         //the previous chunk ended with a backslash inside a string
+    std::vector<char> m_stack;     //'[' or '{' for each open container
+    const char *m_token_begin = nullptr;
+    std::string m_token;           //the start of a token that did not fit in its chunk
+    std::string m_value;
+    std::string m_error;
+    ParseStatus m_status;
+    //positions in the whole input: the chunk being fed starts at m_offset, the current token at
+    //m_token_offset, and the lines are counted up to m_counted
+    const char *m_chunk = nullptr;
+    size_t m_offset = 0;
+    size_t m_token_offset = 0;
+    size_t m_counted = 0;
+    size_t m_line = 1;
+    size_t m_line_begin = 0;       //offset of the first byte of line m_line
+};
+
+//how NdjsonReader spreads the work
+struct NdjsonOptions {
+    //worker threads, 0 for one per core
+    unsigned threads = 0;
+    //the input is cut into chunks of about this many bytes, on line boundaries
+    size_t chunk_size = 256 * 1024;
+    //the callback runs on the worker threads: with `ordered`, one record at a time and in input order,
+    //otherwise concurrently, as soon as each record is parsed
+    bool ordered = true;
+};
+
+//one line of the input: its document, or the reason it is not one
+struct NdjsonRecord {
+    size_t offset;     //of the line in the input
+    Json value;
+    std::string error; //empty when the line parsed
+};
+
+//Newline-delimited JSON, one document per line, parsed on a pool of threads that live as long as the
+//reader. Every worker takes the chunks of its own queue, and steals from the others when it runs out.
+//Blank lines are skipped; a line that fails to parse is still a record, with its error.
+class NdjsonReader final {
+public:
+    //return false to stop the reading. An exception thrown by the callback stops it as well, and
+    //leaves read() once the workers are done.
+    using Callback = std::function<bool(NdjsonRecord &)>;
+
+    explicit NdjsonReader(const NdjsonOptions &options = NdjsonOptions());
+    ~NdjsonReader();
+    NdjsonReader(const NdjsonReader&) = delete;
+    NdjsonReader& operator=(const NdjsonReader&) = delete;
+
+    //false when the callback stopped the reading. One read at a time per reader.
+    bool read(const char *data, size_t size, const Callback &callback);
+    bool read(const std::string &text, const Callback &callback) {return read(text.data(), text.size(), callback);}
+    //read a file through a read-only mapping, false with the message in err when it can't be mapped
+    bool read_file(const std::string &path, std::string &err, const Callback &callback);
+    unsigned threads() const;
+
+private:
+    NdjsonOptions m_options;
+    std::unique_ptr<WorkPool> m_pool;
+};
+
+//Destination of Json::serialize(JsonSink &): the text arrives in blocks of up to 16 KB, or in one
+//piece for a longer string. write() returns false on failure, the rest of the document is then dropped.
+class JsonSink {
+public:
+    virtual ~JsonSink() = default;
+    virtual bool write(const char *data, size_t size) = 0;
+};
+
+//appends to a std::string
+class StringSink final : public JsonSink {
+public:
+    explicit StringSink(std::string &out) : m_out(out) {}
+    bool write(const char *data, size_t size) override;
+
+private:
+    std::string &m_out;
+};
+
+//fills a caller buffer and fails when it is full, Json::serialized_size() tells how large it must be
+class BufferSink final : public JsonSink {
+public:
+    BufferSink(char *data, size_t capacity) : m_data(data), m_capacity(capacity) {}
+    bool write(const char *data, size_t size) override;
+    size_t size() const {return m_size;}
+
+private:
+    char *m_data;
+    size_t m_capacity;
+    size_t m_size = 0;
+};
+
+//fwrite() to a stdio stream, the stream is neither flushed nor closed
+class FileSink final : public JsonSink {
+public:
+    explicit FileSink(std::FILE *file) : m_file(file) {}
+    bool write(const char *data, size_t size) override;
+
+private:
+    std::FILE *m_file;
+};
+
+//write() to a file descriptor (file, pipe, socket), until everything is written
+class FdSink final : public JsonSink {
+public:
+    explicit FdSink(int fd) : m_fd(fd) {}
+    bool write(const char *data, size_t size) override;
+
+private:
+    int m_fd;
+};
+
+class CallbackSink final : public JsonSink {
+public:
+    explicit CallbackSink(std::function<bool(const char *, size_t)> callback) : m_callback(std::move(callback)) {}
+    bool write(const char *data, size_t size) override {return m_callback(data, size);}
+
+private:
+    std::function<bool(const char *, size_t)> m_callback;
+};
+
+//bump allocator for the parser: the nodes of a document are carved out of a few big chunks,
+//and all of them are released at once when the arena is destroyed
+class Arena final {
+public:
+    explicit Arena(size_t chunk_size = 64 * 1024);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+    //bytes handed out so far, and bytes reserved from the system
+    size_t bytes_used() const {return m_used;}
+    size_t bytes_reserved() const {return m_reserved;}
+
+private:
+    friend class Json;
+    friend class Json::Parser;
+
+    struct Chunk{
+        Chunk *next;
+    };
+    static size_t chunk_header();
+    //start over in the newest chunk and release the others, once no node is left in the arena
+    void rewind();
+    Chunk *m_chunks;
+    char *m_cur;
+    char *m_end;
+    size_t m_chunk_size;
+    size_t m_used;
+    size_t m_reserved;
+    //live nodes, and the owner that keeps a document-owned arena alive until the last one is gone
+    std::atomic<size_t> m_nodes;
+    std::shared_ptr<Arena> m_self;
+    //what the nodes may point into, a mapped file for instance, released with the arena
+    std::shared_ptr<void> m_backing;
 };
 
-}
\ No newline at end of file
+}
@@ -1,8 +1,20 @@
 #include "json.hpp"
+#include "alloc_count.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <cassert>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <new>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
 
 
 #define JSON11_TEST_ASSERT(b) assert(b)
@@ -14,6 +26,31 @@
 #define TEST_PARSE_NUMBER test4()
 #define TEST_PARSE_ARRAY test5()
 #define TEST_PARSE_OBJECT test6()
+#define TEST_COPY_SHARES test7()
+#define TEST_PARSE_NO_COPIES test8()
+#define TEST_PARSE_ARENA test9()
+#define TEST_INLINE_SCALARS test10()
+#define TEST_PARSE_LONG_STRINGS test11()
+#define TEST_PARSE_TWO_STAGE test12()
+#define TEST_PARSE_EXACT_NUMBERS test13()
+#define TEST_SERIALIZE_NUMBERS test14()
+#define TEST_PARSE_STREAM test15()
+#define TEST_PARSE_FILE test16()
+#define TEST_FLAT_OBJECT test17()
+#define TEST_INTERNED_KEYS test18()
+#define TEST_PARSE_LAZY test19()
+#define TEST_JSON_PATH test20()
+#define TEST_SERIALIZE_SINKS test21()
+#define TEST_SERIALIZE_ESCAPES test22()
+#define TEST_SERIALIZE_OPTIONS test23()
+#define TEST_CBOR test24()
+#define TEST_NDJSON test25()
+#define TEST_PARSE_PARALLEL test26()
+#define TEST_PARSE_STATUS test27()
+#define TEST_PARSE_DEPTH test28()
+#define TEST_PARSER test29()
+#define TEST_STRICT_UTF8 test30()
+#define TEST_EDIT test31()
 
 using namespace lxjson;
 
@@ -106,6 +143,1340 @@ void test6() {
     JSON11_TEST_ASSERT(m.at("k3").is_array());
 }
 
+void test7() {
+    //copies share the value, they do not deep copy the subtree
+    Json::array big(1000, Json("payload"));
+    Json j_arr(std::move(big));
+    Json j_obj(Json::object { { "k", j_arr } });
+
+    Json copy_arr = j_arr;
+    Json copy_obj(j_obj);
+    JSON11_TEST_ASSERT(&copy_arr.array_value() == &j_arr.array_value());
+    JSON11_TEST_ASSERT(&copy_obj.object_value() == &j_obj.object_value());
+    JSON11_TEST_ASSERT(&copy_obj["k"].array_value() == &j_arr.array_value());
+    JSON11_TEST_ASSERT(copy_arr == j_arr);
+
+    Json assigned;
+    assigned = copy_obj;
+    JSON11_TEST_ASSERT(&assigned.object_value() == &j_obj.object_value());
+}
+
+static size_t count_parse_allocs(const std::string &in){
+    std::string err_com;
+    size_t before = alloc_count;
+    Json ret = Json::parse(in, err_com);
+    JSON11_TEST_ASSERT(err_com.empty());
+    return alloc_count - before;
+}
+
+static std::string nested(const std::string &open, const std::string &leaf, const std::string &close, size_t depth){
+    std::string out;
+    for (size_t i = 0; i < depth; ++i) out += open;
+    out += leaf;
+    for (size_t i = 0; i < depth; ++i) out += close;
+    return out;
+}
+
+void test8() {
+    //children are moved into their parents: every nesting level costs exactly its own
+    //node and its container storage, never a copy of the subtree below it. The first
+    //parses leave the parser's stacks of open containers large enough for the others.
+    count_parse_allocs(nested("[", "1", "]", 65));
+    count_parse_allocs(nested("{\"k\":", "1", "}", 65));
+    size_t arr_1 = count_parse_allocs(nested("[", "1", "]", 1));
+    size_t arr_65 = count_parse_allocs(nested("[", "1", "]", 65));
+    JSON11_TEST_ASSERT(arr_65 - arr_1 == 64 * 2);
+
+    size_t obj_1 = count_parse_allocs(nested("{\"k\":", "1", "}", 1));
+    size_t obj_65 = count_parse_allocs(nested("{\"k\":", "1", "}", 65));
+    JSON11_TEST_ASSERT(obj_65 - obj_1 == 64 * 2);
+}
+
+void test9() {
+    std::string test = R"( {"k1":"v1", "k2":42, "k3":["a",123,true,false,null,{"k4":1.5}]} )";
+    std::string err_com;
+    Json heap = Json::parse(test, err_com);
+    JSON11_TEST_ASSERT(err_com.empty());
+
+    //caller-supplied arena: same document, fewer trips to the heap
+    {
+        Arena arena;
+        size_t before = alloc_count;
+        Json ret = Json::parse(test, err_com, arena);
+        size_t arena_allocs = alloc_count - before;
+        JSON11_TEST_ASSERT(err_com.empty());
+        JSON11_TEST_ASSERT(ret == heap);
+        JSON11_TEST_ASSERT(arena.bytes_used() > 0);
+        JSON11_TEST_ASSERT(arena_allocs < count_parse_allocs(test));
+    }
+
+    //document-owned arena: the arena lives as long as any node of the document
+    Json sub;
+    {
+        Json ret = Json::parse(test, err_com, std::make_shared<Arena>(256));
+        JSON11_TEST_ASSERT(err_com.empty());
+        JSON11_TEST_ASSERT(ret == heap);
+        sub = ret["k3"];
+    }
+    JSON11_TEST_ASSERT(sub == heap["k3"]);
+    JSON11_TEST_ASSERT(sub[5]["k4"].double_value() == 1.5);
+
+    Json bad = Json::parse("[1, 2", err_com, std::make_shared<Arena>());
+    JSON11_TEST_ASSERT(!err_com.empty() && bad.is_null());
+}
+
+void test10() {
+    //null, bool and numbers live inside the 16-byte Json, no heap involved
+    JSON11_TEST_ASSERT(sizeof(Json) == 16);
+    size_t before = alloc_count;
+    Json n(nullptr), b(true), i(42), d(0.5);
+    Json copy_d = d;
+    JSON11_TEST_ASSERT(alloc_count == before);
+    JSON11_TEST_ASSERT(n.is_null() && b.bool_value() && i.int_value() == 42 && copy_d.double_value() == 0.5);
+    JSON11_TEST_ASSERT(i == Json(42.0) && i < Json(42.5) && Json(false) < b);
+    JSON11_TEST_ASSERT(i.type() == Json::JsonType::T_NUMBER && !i.is_string());
+
+    //a numeric array is one node holding a contiguous vector of values
+    Json arr(Json::array{Json(1), Json(2.5), Json(true), Json()});
+    const Json::array &values = arr.array_value();
+    JSON11_TEST_ASSERT(&values[1] == &values[0] + 1);
+    JSON11_TEST_ASSERT(arr[1].double_value() == 2.5 && arr[3].is_null() && arr[9].is_null());
+    JSON11_TEST_ASSERT(count_parse_allocs("[1, 2.5, true, null, -3e2, 0]") <= 1 + 4);
+}
+
+void test11() {
+    //put escapes, control characters and whitespace runs at every offset around the 16/32-byte blocks
+    std::string err_com;
+    for (size_t n = 0; n < 80; ++n){
+        std::string plain(n, 'x');
+        Json ret = Json::parse("\"" + plain + "\\n\\u00e9" + plain + "\\\"end\"", err_com);
+        JSON11_TEST_ASSERT(err_com.empty());
+        JSON11_TEST_ASSERT(ret.string_value() == plain + "\n\xC3\xA9" + plain + "\"end");
+
+        std::string spaces;
+        for (size_t i = 0; i < n; ++i) spaces += " \t\r\n"[i % 4];
+        ret = Json::parse(spaces + "[" + spaces + "\"" + plain + "\"" + spaces + "," + spaces + "1" + spaces + "]" + spaces, err_com);
+        JSON11_TEST_ASSERT(err_com.empty());
+        JSON11_TEST_ASSERT(ret[0].string_value() == plain && ret[1].int_value() == 1);
+
+        Json bad = Json::parse("\"" + plain + "\x01" + plain + "\"", err_com);
+        JSON11_TEST_ASSERT(!err_com.empty() && bad.is_null());
+        err_com.clear();
+        bad = Json::parse("\"" + plain + plain, err_com);
+        JSON11_TEST_ASSERT(!err_com.empty() && bad.is_null());
+        err_com.clear();
+    }
+    //non-ASCII bytes are not control characters
+    std::string utf8 = "\xE4\xBD\xA0\xE5\xA5\xBD, \xE4\xB8\x96\xE7\x95\x8C! \xE4\xBD\xA0\xE5\xA5\xBD, \xE4\xB8\x96\xE7\x95\x8C!";
+    Json ret = Json::parse("\"" + utf8 + "\"", err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && ret.string_value() == utf8);
+}
+
+void test12() {
+    //the two-stage engine must agree with the recursive one, on values and on errors
+    std::string pad(61, ' ');
+    std::vector<std::string> good = {
+        "null", " true ", "false", "0", "-12.5e3", R"("a\"b")", "[]", "{}", "[[],{}]",
+        R"( {"k1":"v1", "k2":42, "k3":["a",123,true,false,null,{"k4":1.5}]} )",
+        R"(["\\", "\\\"", "x\\\\\"y", "\u00e9\n", "{[,:]}"])",
+        //escapes and strings across the 64-byte blocks
+        "[" + pad + R"("\\\\\\\"]\\",1])",
+        "[\"" + pad + pad + "\",\"" + pad + "\"]",
+        "{" + pad + "\"key\"" + pad + ":" + pad + "[1" + pad + ",2]}",
+    };
+    for (auto &in : good){
+        std::string err1, err2;
+        Json expected = Json::parse(in, err1);
+        Json ret = Json::parse(in, err2, Json::ParseEngine::TWO_STAGE);
+        JSON11_TEST_ASSERT(err1.empty() && err2.empty());
+        JSON11_TEST_ASSERT(ret == expected);
+    }
+    std::vector<std::string> bad = {
+        "", "   ", "[", "]", "[1,]", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{1:2}", "\"abc", "[\"a\\\"]",
+        "tru", "truex", "nul", "[1]x", "01", "1.", "\"a\"\"b\"", "{\"a\":1,}", "[\"\x01\"]", "\"\\u00e\"", "\"\\u 0e9\"",
+        "[1, {\"a\": tru}]", "{\"a\"x:1}", "[1, x \"abc", "[\"a\"x]", "{\"a\": 1 ]", "[" + pad + "\"" + pad,
+        "\n[1,\n {\"a\": \"\\q\"}]",
+    };
+    for (auto &in : bad){
+        std::string err1, err2;
+        Json::parse(in, err1);
+        Json ret = Json::parse(in, err2, Json::ParseEngine::TWO_STAGE);
+        JSON11_TEST_ASSERT(!err1.empty() && err2 == err1 && ret.is_null());
+    }
+    std::string err_tape;
+    Json::parse("[1, {\"a\": tru}]", err_tape, Json::ParseEngine::TWO_STAGE);
+    JSON11_TEST_ASSERT(err_tape == "invalid literal, expected null, true or false at line 1, column 11");
+    Json::parse("\"abc", err_tape, Json::ParseEngine::TWO_STAGE);
+    JSON11_TEST_ASSERT(err_tape == "missing closing quotation mark at line 1, column 1");
+
+    //walking the tape without building the tree
+    JsonTape tape;
+    std::string err_com;
+    JSON11_TEST_ASSERT(tape.parse(R"([1, "two", {"three": [3]}, null])", err_com));
+    size_t i = tape.root();
+    JSON11_TEST_ASSERT(tape.type(i) == Json::JsonType::T_ARRAY);
+    i = tape.next(tape.root() + 1);
+    i = tape.next(i);
+    JSON11_TEST_ASSERT(tape.type(i) == Json::JsonType::T_OBJECT);
+    JSON11_TEST_ASSERT(tape.to_json(i)["three"][0].int_value() == 3);
+    JSON11_TEST_ASSERT(tape.type(tape.next(i)) == Json::JsonType::T_NULL);
+    JSON11_TEST_ASSERT(tape.next(tape.root()) == tape.size());
+    JSON11_TEST_ASSERT(!tape.parse("[1,", err_com) && tape.size() == 0);
+}
+
+void test13() {
+    std::string err_com;
+    //integers stay integers, 64-bit ids keep every digit
+    Json ret = Json::parse("[9007199254740993, -9223372036854775808, 18446744073709551615, 9223372036854775807, 0, -0]", err_com);
+    JSON11_TEST_ASSERT(err_com.empty());
+    JSON11_TEST_ASSERT(ret[0].int64_value() == 9007199254740993LL);
+    JSON11_TEST_ASSERT(ret[1].int64_value() == INT64_MIN);
+    JSON11_TEST_ASSERT(ret[2].uint64_value() == UINT64_MAX);
+    JSON11_TEST_ASSERT(ret[3].int64_value() == INT64_MAX && ret[3].uint64_value() == static_cast<uint64_t>(INT64_MAX));
+    JSON11_TEST_ASSERT(ret[4].int_value() == 0 && ret[5].double_value() == 0 && std::signbit(ret[5].double_value()));
+    JSON11_TEST_ASSERT(ret[0] != Json(9007199254740992.0) && ret[0] > Json(static_cast<int64_t>(9007199254740992LL)));
+    JSON11_TEST_ASSERT(ret[2] > ret[3] && ret[1] < ret[4] && Json(1) == Json(1.0));
+    JSON11_TEST_ASSERT(ret.serialize() == "[9007199254740993, -9223372036854775808, 18446744073709551615, 9223372036854775807, 0, -0]");
+    JSON11_TEST_ASSERT(Json::parse(ret.serialize(), err_com, Json::ParseEngine::TWO_STAGE) == ret);
+
+    //too big for 64 bits: a double
+    ret = Json::parse("18446744073709551616", err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && ret.double_value() == 18446744073709551616.0);
+
+    //doubles are correctly rounded, whatever the path
+    struct { const char *in; double expected; } doubles[] = {
+        {"0.1", 0.1}, {"-12.5e3", -12500}, {"1e23", 1e23}, {"2.2250738585072014e-308", 2.2250738585072014e-308},
+        {"4.9406564584124654e-324", 4.9406564584124654e-324}, {"1.7976931348623157e308", 1.7976931348623157e308},
+        {"0.000001234", 0.000001234}, {"1e-400", 0}, {"123456789012345678901234567890", 1.2345678901234568e29},
+        {"9007199254740993.0", 9007199254740992.0}, {"-33.8688197", -33.8688197},
+    };
+    for (auto &d : doubles){
+        ret = Json::parse(d.in, err_com);
+        JSON11_TEST_ASSERT(err_com.empty() && ret.double_value() == d.expected);
+    }
+    ret = Json::parse("1e400", err_com);
+    JSON11_TEST_ASSERT(!err_com.empty() && ret.is_null());
+}
+
+void test14() {
+    //shortest digits, "%.17g" layout
+    struct { double in; const char *expected; } doubles[] = {
+        {0.1, "0.1"}, {0.3, "0.3"}, {-2.5, "-2.5"}, {100, "100"}, {123456, "123456"}, {1e16, "10000000000000000"},
+        {1e17, "1e+17"}, {1e23, "1e+23"}, {0.0001, "0.0001"}, {1.5e-5, "1.5e-05"}, {5e-324, "5e-324"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"}, {2.2250738585072014e-308, "2.2250738585072014e-308"},
+        {9007199254740993.0, "9007199254740992"}, {18446744073709552.0, "18446744073709552"},
+        {-99999999999999984.0, "-99999999999999984"}, {-0.0, "-0"}, {1.0 / 0.0, "null"},
+    };
+    for (auto &d : doubles)
+        JSON11_TEST_ASSERT(Json(d.in).serialize() == d.expected);
+    //above 2^53 the text of an integral double is parsed as an exact integer, it must be the same value
+    for (double d : {18446744073709552.0, -99999999999999984.0, 12345678901234568.0}){
+        std::string err;
+        Json back = Json::parse(Json(d).serialize(), err);
+        JSON11_TEST_ASSERT(err.empty() && back == Json(d) && back.int64_value() == Json(d).int64_value());
+    }
+    JSON11_TEST_ASSERT(Json(static_cast<int64_t>(INT64_MIN)).serialize() == "-9223372036854775808");
+    JSON11_TEST_ASSERT(Json(UINT64_MAX).serialize() == "18446744073709551615");
+    JSON11_TEST_ASSERT(Json(Json::array{Json(0), Json(9), Json(10), Json(-99), Json(100)}).serialize() == "[0, 9, 10, -99, 100]");
+
+    //any finite double survives serialize + parse bit for bit
+    std::string err_com;
+    uint64_t state = 88172645463325252ULL;
+    for (int i = 0; i < 100000; ++i){
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        uint64_t bits = i % 2 ? state : state >> (state % 64);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (!std::isfinite(d)) continue;
+        Json ret = Json::parse(Json(d).serialize(), err_com);
+        double back = ret.double_value();
+        JSON11_TEST_ASSERT(err_com.empty() && ret.is_number() && memcmp(&back, &d, sizeof(d)) == 0);
+        JSON11_TEST_ASSERT(ret == Json(d));
+    }
+}
+
+//rebuilds the tree from the events, to compare the streaming parser with Json::parse
+struct TreeBuilder : JsonHandler {
+    std::vector<Json::array> arrays;
+    std::vector<Json::object> objects;
+    std::vector<std::string> keys;
+    std::vector<char> open;
+    Json root;
+    size_t events = 0, stop_after = SIZE_MAX;
+
+    bool add(Json value){
+        if (open.empty()) root = value;
+        else if (open.back() == '[') arrays.back().push_back(value);
+        else {
+            objects.back().emplace(keys.back(), value);
+            keys.pop_back();
+        }
+        return ++events < stop_after;
+    }
+    bool on_null() override {return add(Json(nullptr));}
+    bool on_bool(bool value) override {return add(Json(value));}
+    bool on_number(const Json &value) override {return add(value);}
+    bool on_string(const std::string &value) override {return add(Json(value));}
+    bool start_array() override {open.push_back('['); arrays.emplace_back(); return true;}
+    bool end_array() override {
+        Json value(std::move(arrays.back()));
+        arrays.pop_back();
+        open.pop_back();
+        return add(value);
+    }
+    bool start_object() override {open.push_back('{'); objects.emplace_back(); return true;}
+    bool key(const std::string &key) override {keys.push_back(key); return true;}
+    bool end_object() override {
+        Json value(std::move(objects.back()));
+        objects.pop_back();
+        open.pop_back();
+        return add(value);
+    }
+};
+
+//feed `in` by chunks of `chunk` bytes
+static bool parse_stream(const std::string &in, size_t chunk, TreeBuilder &builder, std::string &err){
+    JsonStream stream(builder);
+    for (size_t i = 0; i < in.size(); i += chunk){
+        if (!stream.feed(in.data() + i, std::min(chunk, in.size() - i), err))
+            return false;
+    }
+    return stream.finish(err);
+}
+
+void test15() {
+    std::vector<std::string> good = {
+        "null", " true ", "false", "0", "-12.5e3", "18446744073709551615", R"("a\"b")", "[]", "{}", "[[],{}]",
+        R"( {"k1":"v1", "k2":42, "k3":["a",123,true,false,null,{"k4":1.5}]} )",
+        R"(["\\", "\\\"", "x\\\\\"y", "\u00e9\n", "\ud83d\ude00", "{[,:]}"])",
+        "[1,-2,3.25e-2,true ,null\n]", R"({"dup":1,"dup":2})",
+    };
+    for (auto &in : good){
+        std::string err_com;
+        Json expected = Json::parse(in, err_com);
+        JSON11_TEST_ASSERT(err_com.empty());
+        for (size_t chunk = 1; chunk <= in.size(); ++chunk){
+            TreeBuilder builder;
+            JSON11_TEST_ASSERT(parse_stream(in, chunk, builder, err_com));
+            JSON11_TEST_ASSERT(builder.root == expected && builder.root.type() == expected.type());
+        }
+    }
+    std::vector<std::string> bad = {
+        "", "   ", "[", "]", "[1,]", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{1:2}", "\"abc", "[\"a\\\"]",
+        "tru", "truex", "nul", "[1]x", "01", "1.", "1.2.3", "-", "\"a\"\"b\"", "{\"a\":1,}", "[\"\x01\"]",
+        "\"\\u00e\"", "\"\\u 0e9\"", "[1}", "{\"a\":1]", "1e400",
+        "[1,\n {\"a\": tru}]", "[\"a\\q\n\"]", "[\"ab\\\n\"]", "\"abc\\", "[\"a\\x\" 1]", "\n\n  [1,\n2\n  3]",
+    };
+    for (auto &in : bad){
+        std::string expected;
+        Json::parse(in, expected);
+        JSON11_TEST_ASSERT(!expected.empty());
+        for (size_t chunk = 1; chunk <= in.size() + 1; ++chunk){
+            TreeBuilder builder;
+            std::string err_com;
+            JSON11_TEST_ASSERT(!parse_stream(in, chunk, builder, err_com) && err_com == expected);
+        }
+    }
+
+    //errors are located in the whole input, across the chunks
+    {
+        TreeBuilder builder;
+        JsonStream stream(builder);
+        std::string err_com;
+        JSON11_TEST_ASSERT(stream.feed("[1,\n 2,\n \"abc", err_com) && stream.feed("def\", ", err_com));
+        JSON11_TEST_ASSERT(err_com.empty() && stream.status().ok());
+        JSON11_TEST_ASSERT(!stream.feed("\n  x]", err_com) && err_com == "invalid value at line 4, column 3");
+        JSON11_TEST_ASSERT(stream.status().error == ParseStatus::Error::INVALID_VALUE && stream.status().offset == 22);
+        JSON11_TEST_ASSERT(!stream.finish(err_com) && err_com == "invalid value at line 4, column 3");
+    }
+    {
+        TreeBuilder builder;
+        JsonStream stream(builder);
+        std::string err_com;
+        JSON11_TEST_ASSERT(stream.feed("{\"k\": [tr", err_com) && stream.feed("ue, nul", err_com) && !stream.feed("x]}", err_com));
+        JSON11_TEST_ASSERT(err_com == "invalid literal, expected null, true or false at line 1, column 14");
+        JSON11_TEST_ASSERT(stream.status().offset == 13);
+        stream.reset();
+        JSON11_TEST_ASSERT(stream.status().ok() && stream.feed("\n[", err_com) && !stream.finish(err_com));
+        JSON11_TEST_ASSERT(stream.status().error == ParseStatus::Error::UNEXPECTED_END && stream.status().offset == 2);
+        JSON11_TEST_ASSERT(stream.status().line == 2 && stream.status().column == 2);
+    }
+
+    //the handler can stop the parse, and the stream can be reused
+    TreeBuilder builder;
+    builder.stop_after = 2;
+    JsonStream stream(builder);
+    std::string err_com;
+    JSON11_TEST_ASSERT(!stream.feed("[1, 2, 3]", err_com) && err_com == "stopped by the handler");
+    JSON11_TEST_ASSERT(!stream.finish(err_com) && builder.events == 2);
+    stream.reset();
+    builder.stop_after = SIZE_MAX;
+    builder.open.clear();
+    builder.arrays.clear();
+    JSON11_TEST_ASSERT(stream.feed("[4", err_com) && stream.feed("2]", err_com) && stream.finish(err_com));
+    JSON11_TEST_ASSERT(builder.root[0].int_value() == 42);
+}
+
+static std::string write_temp_file(const std::string &content){
+    char path[] = "/tmp/lxjson_test_XXXXXX";
+    int fd = mkstemp(path);
+    JSON11_TEST_ASSERT(fd >= 0);
+    JSON11_TEST_ASSERT(write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+    close(fd);
+    return path;
+}
+
+void test16() {
+    std::string err_com;
+    std::string in = R"({"plain": "abc", "escaped": "a\nb", "list": ["x", "y", 1.5], "empty": ""})";
+    Json expected = Json::parse(in, err_com);
+    std::string path = write_temp_file(in);
+
+    Json copied = Json::parse_file(path, err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && copied == expected);
+
+    //views: the unescaped strings point into the mapping, which outlives the file and the root
+    size_t before = alloc_count;
+    Json viewed = Json::parse_file(path, err_com, Json::StringStorage::VIEW);
+    size_t view_allocs = alloc_count - before;
+    before = alloc_count;
+    Json::parse_file(path, err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && view_allocs < alloc_count - before);
+    unlink(path.c_str());
+    JSON11_TEST_ASSERT(viewed == expected && !(viewed > expected) && !(expected > viewed));
+    Json list = viewed["list"];
+    viewed = Json();
+    JSON11_TEST_ASSERT(list[0].is_string() && list[0].string_view().str() == "x" && list[1].string_value() == "y");
+    JSON11_TEST_ASSERT(list[0] < list[1] && list[1] > Json("x") && list.serialize() == "[\"x\", \"y\", 1.5]");
+
+    //a file that ends exactly on a page boundary, and files that are not there or not JSON
+    std::string page(static_cast<size_t>(sysconf(_SC_PAGESIZE)), ' ');
+    page.replace(0, 5, "[\"a\"]");
+    path = write_temp_file(page);
+    JSON11_TEST_ASSERT(Json::parse_file(path, err_com, Json::StringStorage::VIEW)[0].string_value() == "a" && err_com.empty());
+    unlink(path.c_str());
+    path = write_temp_file("");
+    JSON11_TEST_ASSERT(Json::parse_file(path, err_com).is_null() && !err_com.empty());
+    unlink(path.c_str());
+    err_com.clear();
+    JSON11_TEST_ASSERT(Json::parse_file(path, err_com).is_null() && !err_com.empty());
+
+    //the const char * overload parses in place
+    const char *text = "[\"abc\"]";
+    JSON11_TEST_ASSERT(Json::parse(text, err_com)[0].string_value() == "abc");
+    JSON11_TEST_ASSERT(Json::parse(static_cast<const char *>(nullptr), err_com).is_null() && err_com == "null input");
+}
+
+void test17() {
+    //insertion order, first key wins, std::map-like lookups, below and above the index threshold
+    for (size_t n : {5, 17, 1000}){
+        FlatObject<Json> obj;
+        for (size_t i = n; i-- > 0;)
+            JSON11_TEST_ASSERT(obj.emplace("key" + std::to_string(i), Json(static_cast<int>(i))).second);
+        JSON11_TEST_ASSERT(!obj.emplace("key0", Json(-1)).second && obj.size() == n);
+        JSON11_TEST_ASSERT(obj.begin()->first == "key" + std::to_string(n - 1));
+        for (size_t i = 0; i < n; ++i)
+            JSON11_TEST_ASSERT(obj.at("key" + std::to_string(i)).int_value() == static_cast<int>(i));
+        JSON11_TEST_ASSERT(obj.find("missing") == obj.end() && obj.count("key1") == 1);
+
+        std::vector<FlatObject<Json>::value_type> reversed(obj.begin(), obj.end());
+        std::reverse(reversed.begin(), reversed.end());
+        FlatObject<Json> copy(reversed.begin(), reversed.end());
+        JSON11_TEST_ASSERT(copy == obj && !(copy < obj) && !(obj < copy));
+
+        JSON11_TEST_ASSERT(obj.erase("key0") == 1 && obj.erase("key0") == 0 && obj.size() == n - 1);
+        JSON11_TEST_ASSERT(obj.find("key0") == obj.end() && obj.at("key1").int_value() == 1);
+        JSON11_TEST_ASSERT(obj != copy && obj > copy);
+        obj["key0"] = Json(0);
+        JSON11_TEST_ASSERT(obj == copy && (obj.end() - 1)->first == "key0");
+    }
+    FlatObject<Json> small{{"b", Json(1)}, {"a", Json(2)}};
+    JSON11_TEST_ASSERT(small.begin()->first == "b" && small < (FlatObject<Json>{{"b", Json(0)}}));
+
+    //Json::object is std::map unless LXJSON_FLAT_OBJECT is defined, iteration works the same way
+    Json j_obj(Json::object{{"z", Json(1)}, {"a", Json(2)}});
+    int sum = 0;
+    for (auto &entry : j_obj.object_value())
+        sum += entry.second.int_value() * (entry.first == "z" ? 10 : 1);
+    JSON11_TEST_ASSERT(sum == 12);
+}
+
+static std::string records(size_t n){
+    std::string out = "[";
+    for (size_t i = 0; i < n; ++i)
+        out += std::string(i ? "," : "") + R"({"id": 1, "name": "x", "a long key, past the short string buffer": 2, "flag": true})";
+    return out + "]";
+}
+
+void test18() {
+    KeyTable keys;
+    JsonKey name = keys.intern("name");
+    JSON11_TEST_ASSERT(&keys.intern(std::string("name")).str() == &name.str() && keys.size() == 1);
+    JSON11_TEST_ASSERT(name == JsonKey("name") && name != keys.intern("id") && keys.size() == 2);
+
+    //documents parsed with the same table share their keys
+    std::string err_com;
+    Json doc1 = Json::parse(records(3), err_com, keys), doc2 = Json::parse(records(2), err_com, keys);
+    JSON11_TEST_ASSERT(err_com.empty() && doc1[2] == doc2[1]);
+    JSON11_TEST_ASSERT(doc1[1][name].string_value() == "x" && doc2[0][keys.intern("id")].int_value() == 1);
+#ifdef LXJSON_FLAT_OBJECT
+    JSON11_TEST_ASSERT(keys.size() == 4);
+    JSON11_TEST_ASSERT(&doc1[0].object_value().begin()->first.str() == &doc2[1].object_value().begin()->first.str());
+    //per document by default: past the first record, only the object, its entries and the string value
+    //are allocated, once the parser's buffers have grown to the document
+    count_parse_allocs(records(101));
+    size_t per_record = count_parse_allocs(records(101)) - count_parse_allocs(records(100));
+    JSON11_TEST_ASSERT(per_record == 3);
+#endif
+
+    //the keys outlive the table
+    Json doc3;
+    {
+        KeyTable scoped;
+        doc3 = Json::parse(records(1), err_com, scoped);
+    }
+    JSON11_TEST_ASSERT(doc3[0]["flag"].bool_value() && doc3.serialize() == Json::parse(doc3.serialize(), err_com).serialize());
+
+    //a shared table can be filled from several threads
+    KeyTable shared(true);
+    std::vector<std::thread> threads;
+    std::vector<const std::string *> seen(4);
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&shared, &seen, t]{
+            for (int i = 0; i < 1000; ++i)
+                shared.intern("key" + std::to_string((i * 7 + t) % 1000));
+            seen[t] = &shared.intern("key0").str();
+        });
+    for (auto &thread : threads) thread.join();
+    JSON11_TEST_ASSERT(shared.size() == 1000 && seen[0] == seen[1] && seen[1] == seen[2] && seen[2] == seen[3]);
+}
+
+void test19() {
+    //brackets and escaped quotes inside the strings must not confuse the containers that are passed over
+    std::vector<std::string> good = {
+        "null", " 12 ", R"("s")", "[]", "{}", "[[],{}]", "[[[[1]]], {\"a\": [{}]}]",
+        R"( {"k1":"v1", "k2":42, "k3":["a",123,true,false,null,{"k4":1.5}]} )",
+        R"([{"]": "[", "}": "{"}, ["\"]", "x\\", "\\\"}"], "é\n", "😀", {"dup":1,"dup":2}])",
+    };
+    for (auto &in : good){
+        std::string err_com;
+        Json expected = Json::parse(in, err_com);
+        Json lazy = Json::parse(in, err_com, Json::ParseEngine::LAZY);
+        JSON11_TEST_ASSERT(err_com.empty() && lazy.type() == expected.type());
+        JSON11_TEST_ASSERT(lazy == expected && expected == lazy && lazy.serialize() == expected.serialize());
+    }
+    //the whole text is validated up front, whatever is accessed later
+    std::vector<std::string> bad = {
+        "", "[", "[1,]", "[1 2]", "{\"a\" 1}", "{1:2}", "[\"abc]", "[[[tru]]]", "[1]x", "[{\"a\":[01]}]",
+        "[[\"\x01\"]]", "{\"a\":{\"b\":1e400}}", "[1}", "{\"a\":[1]]",
+    };
+    for (auto &in : bad){
+        std::string expected, err_com;
+        Json::parse(in, expected);
+        JSON11_TEST_ASSERT(Json::parse(in, err_com, Json::ParseEngine::LAZY).is_null() && err_com == expected);
+    }
+
+    //containers are built one level at a time, on first access, and copies share what was built
+    std::string err_com;
+    Json doc = Json::parse(R"({"list": [1, [2, 3], {"x": "y"}], "n": 1.5})", err_com, Json::ParseEngine::LAZY);
+    Json copy = doc;
+    JSON11_TEST_ASSERT(doc.is_object() && doc["list"].is_array() && doc["list"][2].is_object());
+    JSON11_TEST_ASSERT(&copy["list"][1] == &doc["list"][1] && copy["list"][1][1].int_value() == 3);
+    JSON11_TEST_ASSERT(doc["list"][2]["x"].string_value() == "y" && doc["n"].double_value() == 1.5);
+    JSON11_TEST_ASSERT(doc["list"].array_value().size() == 3 && doc.object_value().size() == 2);
+    JSON11_TEST_ASSERT(doc["list"][1] > Json::parse("[2, 2]", err_com) && !doc["list"][5].is_object());
+    //the text lives as long as the containers that point into it
+    Json inner = doc["list"][2];
+    doc = copy = Json();
+    JSON11_TEST_ASSERT(inner.serialize() == "{\"x\": \"y\"}");
+
+    //concurrent first accesses build a container once
+    Json shared = Json::parse(records(100), err_com, Json::ParseEngine::LAZY);
+    std::vector<std::thread> threads;
+    std::vector<const Json *> seen(4);
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&shared, &seen, t]{
+            seen[t] = &shared[99]["name"];
+        });
+    for (auto &thread : threads) thread.join();
+    JSON11_TEST_ASSERT(seen[0] == seen[1] && seen[1] == seen[2] && seen[2] == seen[3] && seen[0]->string_value() == "x");
+}
+
+static std::string serialize_all(const std::vector<Json> &values){
+    std::string out;
+    for (auto &value : values) out += value.serialize() + ";";
+    return out;
+}
+
+void test20() {
+    //the examples of RFC 6901
+    std::string err_com;
+    std::string rfc = R"({"foo": ["bar", "baz"], "": 0, "a/b": 1, "c%d": 2, "e^f": 3, "g|h": 4, "i\\j": 5,
+                         "k\"l": 6, " ": 7, "m~n": 8})";
+    Json doc = Json::parse(rfc, err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && JsonPath::pointer("").find(doc) == &doc);
+    JSON11_TEST_ASSERT(*JsonPath::pointer("/foo").find(doc) == doc["foo"]);
+    JSON11_TEST_ASSERT(JsonPath::pointer("/foo/0").find(doc)->string_value() == "bar");
+    const char *pointers[] = {"/", "/a~1b", "/c%d", "/e^f", "/g|h", "/i\\j", "/k\"l", "/ ", "/m~0n"};
+    for (int i = 0; i < 9; ++i)
+        JSON11_TEST_ASSERT(JsonPath::pointer(pointers[i]).find(doc)->int_value() == (i ? i : 0));
+    JSON11_TEST_ASSERT(!JsonPath::pointer("/foo/2").find(doc) && !JsonPath::pointer("/foo/-").find(doc));
+    JSON11_TEST_ASSERT(!JsonPath::pointer("/foo/01").find(doc) && !JsonPath::pointer("/nope/0").find(doc));
+    for (const char *bad : {"foo", "/m~2n", "/m~"}){
+        bool thrown = false;
+        try { JsonPath::pointer(bad); } catch (std::runtime_error &) { thrown = true; }
+        JSON11_TEST_ASSERT(thrown);
+    }
+
+    //path expressions, evaluated on the tree and on the text
+    std::string store = R"({"store": {"book": [
+        {"title": "A", "price": 8, "tags": ["x"]}, {"title": "B", "price": 12},
+        {"title": "C", "price": 9, "tags": ["y", "z"]}, {"title": "D", "price": 22}],
+        "bicycle": {"color": "red", "price": 19}, "odd key": [1, 2]}})";
+    Json tree = Json::parse(store, err_com);
+    std::vector<std::pair<std::string, std::string>> cases = {
+        {"$", tree.serialize() + ";"},
+        {"$.store.book[0].title", "\"A\";"},
+        {"store.book[-1].title", "\"D\";"},
+        {"$.store.book[*].price", "8;12;9;22;"},
+        {"$.store.book[1:3].title", "\"B\";\"C\";"},
+        {"$.store.book[-2:].title", "\"C\";\"D\";"},
+        {"$.store.book[:-3].title", "\"A\";"},
+        {"$.store.book[5:].title", ""},
+        {"$.store.book[*].tags[0]", "\"x\";\"y\";"},
+        {"$['store'][\"odd key\"][1]", "2;"},
+        {"$.store.bicycle.*", "\"red\";19;"},
+        {"$.store.book.title", ""},
+        {"$.store.book[9]", ""},
+        {"$.nothing[*]", ""},
+    };
+    for (auto &c : cases){
+        JsonPath path(c.first);
+        JSON11_TEST_ASSERT(serialize_all(path.select(tree)) == c.second);
+        JSON11_TEST_ASSERT(serialize_all(path.select(store, err_com)) == c.second && err_com.empty());
+    }
+    for (const char *bad : {"$.", "$[", "$[1", "$['a", "$[-]", "$x", "$.a[b]"}){
+        bool thrown = false;
+        try { JsonPath path(bad); } catch (std::runtime_error &) { thrown = true; }
+        JSON11_TEST_ASSERT(thrown);
+    }
+    //the text is still validated outside of the matches
+    JSON11_TEST_ASSERT(JsonPath("$.a").select(R"({"a": 1, "b": [1,]})", err_com).empty() && !err_com.empty());
+
+    //a compiled query and a key passed by reference do not allocate
+    JsonPath price("$.store.book[*].price");
+    const std::string key = "store";
+    double total = 0;
+    size_t before = alloc_count;
+    price.visit(tree, [&total](const Json &value){ total += value.double_value(); });
+    const Json &found = tree[key];
+    JSON11_TEST_ASSERT(alloc_count == before && total == 51 && found.is_object());
+}
+
+void test21() {
+    std::string err_com;
+    std::vector<std::string> docs = {
+        "null", "-0", "[]", "{}", "18446744073709551615", "-9223372036854775808", "[1e300, -2.5e-8, 0.1, 100]",
+        R"({"a\"b": ["\u0001\t\\", true, false, null, {"": ""}], "n": -12})",
+    };
+    docs.push_back(Json(std::string(100000, 'x')).serialize()); //longer than a block of the writer
+    Json big = Json::parse(records(2000), err_com);
+    docs.push_back(big.serialize());
+    for (auto &in : docs){
+        Json value = Json::parse(in, err_com);
+        std::string expected = value.serialize(), out = "prefix";
+        value.serialize(out);
+        JSON11_TEST_ASSERT(err_com.empty() && value.serialized_size() == expected.size() && out == "prefix" + expected);
+
+        std::string streamed;
+        StringSink to_string(streamed);
+        JSON11_TEST_ASSERT(value.serialize(to_string) && streamed == expected);
+
+        //a buffer of exactly the right size is enough, one byte less is not
+        std::vector<char> buffer(expected.size());
+        BufferSink exact(buffer.data(), buffer.size());
+        JSON11_TEST_ASSERT(value.serialize(exact) && std::string(buffer.data(), exact.size()) == expected);
+        BufferSink small(buffer.data(), buffer.size() - 1);
+        JSON11_TEST_ASSERT(!value.serialize(small));
+    }
+
+    //blocks reach the callback as the document is written, a failure stops the output
+    size_t blocks = 0, total = 0;
+    CallbackSink counter([&](const char *, size_t size){ ++blocks; total += size; return true; });
+    JSON11_TEST_ASSERT(big.serialize(counter) && blocks > 1 && total == big.serialized_size());
+    blocks = 0;
+    CallbackSink failing([&](const char *, size_t){ ++blocks; return false; });
+    JSON11_TEST_ASSERT(!big.serialize(failing) && blocks == 1);
+
+    //files, through stdio or a descriptor
+    std::string path = write_temp_file("");
+    FILE *file = fopen(path.c_str(), "w");
+    FileSink to_file(file);
+    JSON11_TEST_ASSERT(big.serialize(to_file) && fclose(file) == 0);
+    JSON11_TEST_ASSERT(Json::parse_file(path, err_com) == big);
+    int fd = open(path.c_str(), O_WRONLY | O_TRUNC);
+    FdSink to_fd(fd);
+    JSON11_TEST_ASSERT(Json(Json::array{Json(1), Json("two")}).serialize(to_fd) && close(fd) == 0);
+    JSON11_TEST_ASSERT(Json::parse_file(path, err_com).serialize() == "[1, \"two\"]");
+    unlink(path.c_str());
+}
+
+//one character at a time, as the serializer used to
+static std::string escape_reference(const std::string &in){
+    std::string out = "\"";
+    for (unsigned char c : in){
+        switch (c){
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20){
+                    char buf[7];
+                    snprintf(buf, sizeof(buf), "\\u%04X", c);
+                    out += buf;
+                }
+                else out += static_cast<char>(c);
+        }
+    }
+    return out + "\"";
+}
+
+void test22() {
+    //every special character at every offset around the 16 and 32-byte blocks of the scanners
+    std::string err_com;
+    for (int c = 0; c < 0x80; ++c){
+        for (size_t at : {0, 1, 15, 16, 17, 31, 32, 33, 63}){
+            std::string in(70, 'a');
+            in[at] = static_cast<char>(c);
+            Json value(in);
+            std::string out = value.serialize();
+            JSON11_TEST_ASSERT(out == escape_reference(in) && value.serialized_size() == out.size());
+            JSON11_TEST_ASSERT(Json::parse(out, err_com) == value);
+        }
+    }
+
+    //non-ASCII text: copied, checked or escaped
+    SerializeOptions validate, escape;
+    validate.unicode = SerializeOptions::Unicode::VALIDATE;
+    escape.unicode = SerializeOptions::Unicode::ESCAPE;
+    Json text("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\n");
+    JSON11_TEST_ASSERT(text.serialize() == "\"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\\n\"");
+    JSON11_TEST_ASSERT(text.serialize(validate) == text.serialize());
+    std::string escaped = text.serialize(escape);
+    JSON11_TEST_ASSERT(escaped == "\"caf\\u00E9 \\u20AC \\uD83D\\uDE00\\n\"" && text.serialized_size(escape) == escaped.size());
+    JSON11_TEST_ASSERT(Json::parse(escaped, err_com) == text);
+
+    //truncated, overlong, surrogate, beyond U+10FFFF, stray continuation byte
+    for (const char *bad : {"\xE2\x82", "\xC0\x80", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "a\x80"}){
+        Json value(std::string(bad) + std::string(40, 'x'));
+        JSON11_TEST_ASSERT(value.serialize().size() == value.serialized_size());
+        for (auto *options : {&validate, &escape}){
+            bool thrown = false;
+            try { value.serialize(*options); } catch (std::runtime_error &) { thrown = true; }
+            JSON11_TEST_ASSERT(thrown);
+            //what was in the string before is left as it was
+            std::string out = "prefix";
+            thrown = false;
+            try { value.serialize(out, *options); } catch (std::runtime_error &) { thrown = true; }
+            JSON11_TEST_ASSERT(thrown && out == "prefix");
+        }
+    }
+}
+
+
+void test23() {
+    std::string err_com;
+    Json doc = Json::parse(R"({"b": [1, 2.5, "x"], "a": {}, "c": [], "d": {"e": null, "f": [true]}})", err_com);
+    SerializeOptions compact, pretty, indent2;
+    compact.style = SerializeOptions::Style::COMPACT;
+    pretty.style = SerializeOptions::Style::PRETTY;
+    indent2.style = SerializeOptions::Style::PRETTY;
+    indent2.indent = 2;
+
+    //std::map keeps the keys sorted, FlatObject keeps them in insertion order
+#ifdef LXJSON_FLAT_OBJECT
+    const char *keys[] = {"b", "a", "c", "d"};
+#else
+    const char *keys[] = {"a", "b", "c", "d"};
+#endif
+    std::map<std::string, std::string> member = {
+        {"a", "\"a\":{}"}, {"b", "\"b\":[1,2.5,\"x\"]"}, {"c", "\"c\":[]"}, {"d", "\"d\":{\"e\":null,\"f\":[true]}"}
+    };
+    std::string expect = "{";
+    for (const char *key : keys) expect += (expect.size() > 1 ? "," : "") + member[key];
+    expect += "}";
+    JSON11_TEST_ASSERT(doc.serialize(compact) == expect);
+
+    std::map<std::string, std::string> lines = {
+        {"a", "  \"a\": {}"}, {"b", "  \"b\": [\n    1,\n    2.5,\n    \"x\"\n  ]"}, {"c", "  \"c\": []"},
+        {"d", "  \"d\": {\n    \"e\": null,\n    \"f\": [\n      true\n    ]\n  }"}
+    };
+    expect = "{";
+    for (const char *key : keys) expect += std::string(expect.size() > 1 ? "," : "") + "\n" + lines[key];
+    expect += "\n}";
+    JSON11_TEST_ASSERT(doc.serialize(indent2) == expect);
+
+    //every style reads back and sizes exactly, through a string and through a sink
+    for (auto *options : {&compact, &pretty, &indent2}){
+        std::string out = doc.serialize(*options);
+        JSON11_TEST_ASSERT(Json::parse(out, err_com) == doc && doc.serialized_size(*options) == out.size());
+        std::string sunk;
+        StringSink sink(sunk);
+        JSON11_TEST_ASSERT(doc.serialize(sink, *options) && sunk == out);
+    }
+    JSON11_TEST_ASSERT(doc.serialize().find(", ") != std::string::npos);
+    JSON11_TEST_ASSERT(Json(Json::array{}).serialize(pretty) == "[]" && Json(1).serialize(pretty) == "1");
+
+    //deep enough for the indentation to need several chunks of spaces
+    Json deep(Json::array{});
+    for (int i = 0; i < 40; ++i) deep = Json(Json::array{deep, Json(i)});
+    std::string out = deep.serialize(pretty);
+    JSON11_TEST_ASSERT(Json::parse(out, err_com) == deep && deep.serialized_size(pretty) == out.size());
+
+    //sorted keys, in any style, whatever the order of the object
+    SerializeOptions sorted = compact;
+    sorted.sort_keys = true;
+    JSON11_TEST_ASSERT(doc.serialize(sorted) == "{\"a\":{},\"b\":[1,2.5,\"x\"],\"c\":[],\"d\":{\"e\":null,\"f\":[true]}}");
+    sorted.style = SerializeOptions::Style::PRETTY;
+    JSON11_TEST_ASSERT(doc.serialize(sorted).size() == doc.serialized_size(sorted));
+    sorted.unicode = SerializeOptions::Unicode::ESCAPE;
+    JSON11_TEST_ASSERT(Json(Json::object{{"\xC3\xA9", Json(1)}, {"z", Json(2)}}).serialize(sorted) == "{\n    \"z\": 2,\n    \"\\u00E9\": 1\n}");
+}
+
+
+//"1a00f4" as the bytes 0x1a 0x00 0xf4
+static std::string from_hex(const std::string &hex){
+    std::string out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+        out.push_back(static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    return out;
+}
+
+void test24() {
+    std::string err_com;
+    //encodings from the examples of RFC 8949
+    const std::pair<const char *, const char *> examples[] = {
+        {"0", "00"}, {"23", "17"}, {"24", "1818"}, {"100", "1864"}, {"1000", "1903e8"}, {"1000000", "1a000f4240"},
+        {"1000000000000", "1b000000e8d4a51000"}, {"18446744073709551615", "1bffffffffffffffff"},
+        {"-1", "20"}, {"-10", "29"}, {"-100", "3863"}, {"-1000", "3903e7"}, {"-9223372036854775808", "3b7fffffffffffffff"},
+        {"1.5", "fa3fc00000"}, {"100000.0", "fa47c35000"}, {"1.1", "fb3ff199999999999a"}, {"-4.1", "fbc010666666666666"},
+        {"false", "f4"}, {"true", "f5"}, {"null", "f6"}, {R"("")", "60"}, {R"("IETF")", "6449455446"},
+        {R"("ü")", "62c3bc"}, {"[]", "80"}, {"[1, 2, 3]", "83010203"}, {"{}", "a0"},
+        {R"({"a": 1, "b": [2, 3]})", "a26161016162820203"},
+    };
+    for (auto &example : examples){
+        Json value = Json::parse(example.first, err_com);
+        std::string cbor = value.to_cbor();
+        JSON11_TEST_ASSERT(cbor == from_hex(example.second));
+        Json back = Json::from_cbor(cbor, err_com);
+        JSON11_TEST_ASSERT(back == value && back.serialize() == value.serialize());
+    }
+
+    //what other encoders may write: half floats, undefined, bignum negatives, indefinite lengths, tags
+    const std::pair<const char *, const char *> decoded[] = {
+        {"f93c00", "1"}, {"f97bff", "65504"}, {"f90001", "5.9604644775390625e-08"}, {"f7", "null"},
+        {"3bffffffffffffffff", "-1.8446744073709552e+19"}, {"9f018202039f0405ffff", "[1, [2, 3], [4, 5]]"},
+        {"bf61610161629f0203ffff", R"({"a": 1, "b": [2, 3]})"}, {"7f657374726561646d696e67ff", R"("streaming")"},
+        {"c11a514b67b0", "1363896240"},
+    };
+    for (auto &example : decoded){
+        JSON11_TEST_ASSERT(Json::from_cbor(from_hex(example.first), err_com) == Json::parse(example.second, err_com));
+    }
+    JSON11_TEST_ASSERT(std::isinf(Json::from_cbor(from_hex("f9fc00"), err_com).double_value()));
+
+    //a document of every kind, appended after what the string holds, and one parsed lazily
+    std::string in = R"({"id": 18446744073709551615, "neg": -123456789012, "pi": 3.141592653589793, "big": 1e300,
+                         "text": "café 😀 \"quoted\"", "list": [null, true, false, [], {}, 0.25],
+                         "records": )" + records(50) + "}";
+    Json doc = Json::parse(in, err_com);
+    std::string out = "head";
+    doc.to_cbor(out);
+    JSON11_TEST_ASSERT(out.compare(0, 4, "head") == 0 && out.size() < 4 + doc.serialize().size());
+    JSON11_TEST_ASSERT(Json::from_cbor(out.data() + 4, out.size() - 4, err_com) == doc);
+    JSON11_TEST_ASSERT(Json::parse(in, err_com, Json::ParseEngine::LAZY).to_cbor() == out.substr(4));
+
+    //every truncation fails, as do the inputs that are not one JSON value
+    std::string cbor = out.substr(4);
+    for (size_t n = 0; n < cbor.size(); n += 1 + n / 8){
+        err_com.clear();
+        JSON11_TEST_ASSERT(Json::from_cbor(cbor.data(), n, err_com).is_null() && !err_com.empty());
+    }
+    const std::pair<const char *, const char *> errors[] = {
+        {"0000", "unexpected trailing bytes after the CBOR item"}, {"4161", "CBOR byte strings have no JSON equivalent"},
+        {"1c", "invalid CBOR argument 28"}, {"e0", "unsupported CBOR simple value 0"},
+        {"9bffffffffffffffff00", "truncated CBOR input"}, {"7f4161ff", "invalid chunk in an indefinite-length string"},
+        {"9f01", "truncated CBOR input"}, {"a10102", "CBOR map keys must be text strings"},
+    };
+    for (auto &example : errors){
+        JSON11_TEST_ASSERT(Json::from_cbor(from_hex(example.first), err_com).is_null() && err_com == example.second);
+    }
+    JSON11_TEST_ASSERT(Json::from_cbor(std::string(100000, '\x81') + '\x01', err_com).is_null() &&
+                       err_com == "CBOR nesting deeper than 512");
+}
+
+
+void test25() {
+    //the state of a surrogate pair belongs to the string being parsed: a broken pair leaves nothing behind,
+    //and parsers on several threads don't share it
+    std::string err_com;
+    JSON11_TEST_ASSERT(Json::parse(R"("\uD83D")", err_com).is_null() && !err_com.empty());
+    JSON11_TEST_ASSERT(Json::parse(R"("A")", err_com).string_value() == "A");
+    std::vector<std::thread> parsers;
+    std::atomic<int> wrong(0);
+    for (int t = 0; t < 4; ++t)
+        parsers.emplace_back([&wrong, t]{
+            std::string err;
+            for (int i = 0; i < 2000; ++i){
+                Json value = Json::parse(t % 2 ? R"("😀é")" : R"("€𝄞")", err);
+                if (value.string_value() != (t % 2 ? "\xF0\x9F\x98\x80\xC3\xA9" : "\xE2\x82\xAC\xF0\x9D\x84\x9E")) ++wrong;
+            }
+        });
+    for (auto &parser : parsers) parser.join();
+    JSON11_TEST_ASSERT(wrong == 0);
+
+    //lines of every shape: blank, CRLF, broken, and a last one without its newline
+    std::string in;
+    std::vector<std::pair<size_t, std::string>> lines;
+    for (int i = 0; i < 3000; ++i){
+        std::string line = i % 97 == 5 ? R"({"id": )" : R"({"id": )" + std::to_string(i) + R"(, "tags": ["a", "é"], "ok": true})";
+        if (i % 50 == 7) in += "  \n\n";
+        lines.emplace_back(in.size(), line);
+        in += line + (i % 3 ? "\n" : "\r\n");
+    }
+    in += "[1, 2]";
+    lines.emplace_back(in.size() - 6, "[1, 2]");
+
+    auto check = [&](std::vector<NdjsonRecord> &got){
+        JSON11_TEST_ASSERT(got.size() == lines.size());
+        for (size_t i = 0; i < got.size(); ++i){
+            std::string err;
+            Json expected = Json::parse(lines[i].second, err);
+            JSON11_TEST_ASSERT(got[i].offset == lines[i].first && got[i].error == err && got[i].value == expected);
+        }
+    };
+    for (unsigned threads : {1u, 4u}){
+        for (size_t chunk : {size_t(1), size_t(100), size_t(1) << 20}){
+            NdjsonOptions options;
+            options.threads = threads;
+            options.chunk_size = chunk;
+            NdjsonReader ordered(options);
+            JSON11_TEST_ASSERT(ordered.threads() == threads);
+            std::vector<NdjsonRecord> got;
+            JSON11_TEST_ASSERT(ordered.read(in, [&](NdjsonRecord &record){ got.push_back(std::move(record)); return true; }));
+            check(got);
+
+            options.ordered = false;
+            NdjsonReader unordered(options);
+            std::mutex mutex;
+            got.clear();
+            JSON11_TEST_ASSERT(unordered.read(in, [&](NdjsonRecord &record){
+                std::lock_guard<std::mutex> lock(mutex);
+                got.push_back(std::move(record));
+                return true;
+            }));
+            std::sort(got.begin(), got.end(), [](const NdjsonRecord &a, const NdjsonRecord &b){ return a.offset < b.offset; });
+            check(got);
+        }
+    }
+
+    //stopped by the callback, or by an exception, and the reader is still usable afterwards
+    NdjsonOptions options;
+    options.threads = 3;
+    options.chunk_size = 64;
+    NdjsonReader reader(options);
+    size_t seen = 0;
+    JSON11_TEST_ASSERT(!reader.read(in, [&](NdjsonRecord &){ return ++seen < 10; }) && seen == 10);
+    bool thrown = false;
+    try { reader.read(in, [](NdjsonRecord &record) -> bool { throw std::runtime_error(record.error); }); }
+    catch (std::runtime_error &) { thrown = true; }
+    JSON11_TEST_ASSERT(thrown);
+    options.ordered = false;
+    NdjsonReader unordered(options);
+    thrown = false;
+    try { unordered.read(in, [](NdjsonRecord &) -> bool { throw std::runtime_error("stop"); }); }
+    catch (std::runtime_error &e) { thrown = std::string(e.what()) == "stop"; }
+    JSON11_TEST_ASSERT(thrown);
+    std::atomic<size_t> count(0);
+    JSON11_TEST_ASSERT(!unordered.read(in, [&](NdjsonRecord &){ return ++count < 10; }));
+
+    //from a file, and nothing at all
+    std::string path = write_temp_file(in);
+    seen = 0;
+    JSON11_TEST_ASSERT(reader.read_file(path, err_com, [&](NdjsonRecord &record){ return record.offset == lines[seen++].first; }));
+    JSON11_TEST_ASSERT(seen == lines.size());
+    unlink(path.c_str());
+    JSON11_TEST_ASSERT(!reader.read_file(path, err_com, [](NdjsonRecord &){ return true; }) && !err_com.empty());
+    JSON11_TEST_ASSERT(reader.read("", [](NdjsonRecord &){ return false; }));
+}
+
+
+void test26() {
+    //elements with the characters the pre-scan must not take for structure: commas, brackets and
+    //escaped quotes inside strings, nested containers
+    std::string in = "[";
+    for (int i = 0; i < 6000; ++i){
+        if (i) in += i % 7 ? "," : " ,\n ";
+        switch (i % 4){
+            case 0: in += R"({"id": )" + std::to_string(i) + R"(, "text": "a, [b] {c} \"d,\" \\", "list": [1, [2, {"x": []}]]})"; break;
+            case 1: in += R"("],\\\"[,")"; break;
+            case 2: in += std::to_string(i * 0.5); break;
+            default: in += R"([{}, [], "éé", null, true])"; break;
+        }
+    }
+    in += "]\n";
+    std::string err_com;
+    Json expected = Json::parse(in, err_com);
+    JSON11_TEST_ASSERT(err_com.empty() && expected.array_value().size() == 6000);
+    for (unsigned threads : {1u, 2u, 3u, 8u}){
+        Json value = Json::parse_parallel(in, err_com, threads);
+        JSON11_TEST_ASSERT(err_com.empty() && value == expected);
+    }
+    //the elements keep their arena alive
+    Json element;
+    {
+        Json value = Json::parse(in, err_com, Json::ParseEngine::PARALLEL);
+        JSON11_TEST_ASSERT(value == expected);
+        element = value[4];
+    }
+    JSON11_TEST_ASSERT(element == expected[4] && element["list"][1][1]["x"].is_array());
+
+    //small documents and other roots
+    for (const char *small : {"[]", " [ ] ", "[1]", "[1, [2]]", R"({"a": [1, 2]})", "42", "  \"x\"  "}){
+        Json value = Json::parse_parallel(small, err_com, 4);
+        JSON11_TEST_ASSERT(err_com.empty() && value == Json::parse(small, err_com));
+    }
+
+    //damaged anywhere, the result is that of the serial parser, error included
+    for (size_t at = 1; at < in.size(); at += in.size() / 97){
+        for (char c : {'"', ',', ']', '{', '\\', 'x', '\0'}){
+            std::string broken = in;
+            broken[at] = c;
+            std::string serial_err, parallel_err;
+            Json serial = Json::parse(broken, serial_err), parallel = Json::parse_parallel(broken, parallel_err, 4);
+            JSON11_TEST_ASSERT(parallel_err == serial_err && parallel == serial);
+        }
+    }
+    for (const char *bad : {"[1,]", "[1, 2", "[1] x", "[1}", "[\"a]", "["}){
+        std::string serial_err, parallel_err;
+        JSON11_TEST_ASSERT(Json::parse_parallel(bad, parallel_err, 4).is_null());
+        Json::parse(bad, serial_err);
+        JSON11_TEST_ASSERT(!parallel_err.empty() && parallel_err == serial_err);
+    }
+}
+
+void test27() {
+    using Error = ParseStatus::Error;
+    struct Case{
+        std::string in;
+        Error error;
+        size_t offset, line, column;
+    };
+    const Case cases[] = {
+        {"", Error::UNEXPECTED_END, 0, 1, 1},
+        {"  ", Error::UNEXPECTED_END, 2, 1, 3},
+        {"[1, 2", Error::UNEXPECTED_END, 5, 1, 6},
+        {"[1,]", Error::INVALID_VALUE, 3, 1, 4},
+        {"tru", Error::INVALID_LITERAL, 0, 1, 1},
+        {"[nul]", Error::INVALID_LITERAL, 1, 1, 2},
+        {"01", Error::INVALID_NUMBER, 1, 1, 2},
+        {"1.", Error::INVALID_NUMBER, 2, 1, 3},
+        {"[-]", Error::INVALID_NUMBER, 2, 1, 3},
+        {"1e+", Error::INVALID_NUMBER, 3, 1, 4},
+        {"[0, 1e400]", Error::NUMBER_OUT_OF_RANGE, 4, 1, 5},
+        {"[\"abc", Error::UNTERMINATED_STRING, 1, 1, 2},
+        {"\"ab\\", Error::UNTERMINATED_STRING, 0, 1, 1},
+        {"[\"a\x01\"]", Error::INVALID_STRING_CHARACTER, 3, 1, 4},
+        {"\"a\\qb\"", Error::INVALID_ESCAPE, 2, 1, 3},
+        {"\"\\x41\"", Error::INVALID_ESCAPE, 1, 1, 2},
+        {"[\"\\'\"]", Error::INVALID_ESCAPE, 2, 1, 3},
+        {"\"\\u00e\"", Error::INVALID_UNICODE_ESCAPE, 1, 1, 2},
+        {"\"\\ud800x\"", Error::INVALID_UNICODE_ESCAPE, 7, 1, 8},
+        {"[1 2]", Error::EXPECTED_COMMA_OR_BRACKET, 3, 1, 4},
+        {"{\"a\":1]", Error::EXPECTED_COMMA_OR_BRACE, 6, 1, 7},
+        {"{1:2}", Error::EXPECTED_KEY, 1, 1, 2},
+        {"{\"a\" 1}", Error::EXPECTED_COLON, 5, 1, 6},
+        {"{\n  \"a\": 1,\n  \"b\" 2\n}", Error::EXPECTED_COLON, 18, 3, 7},
+        {"[1]x", Error::TRAILING_CHARACTERS, 3, 1, 4},
+        {std::string("1\0", 2), Error::TRAILING_CHARACTERS, 1, 1, 2},
+        {"[\n\n]]", Error::TRAILING_CHARACTERS, 4, 3, 2},
+    };
+    for (auto &c : cases){
+        ParseStatus status;
+        std::string err;
+        JSON11_TEST_ASSERT(Json::parse(c.in, status).is_null() && !status.ok());
+        JSON11_TEST_ASSERT(status.error == c.error && status.offset == c.offset);
+        JSON11_TEST_ASSERT(status.line == c.line && status.column == c.column);
+        //the message of the other overloads is that of the status
+        JSON11_TEST_ASSERT(Json::parse(c.in, err).is_null() && err == status.message());
+    }
+    ParseStatus status;
+    Json::parse("{\n  \"a\": 1,\n  \"b\" 2\n}", status);
+    JSON11_TEST_ASSERT(status.message() == "expected ':' in object at line 3, column 7");
+
+    //a status is reset by the next parse
+    Json value = Json::parse(R"({"a": [1, "\u00e9"]})", status);
+    JSON11_TEST_ASSERT(status.ok() && status.offset == 0 && value["a"][1].string_value() == "\xC3\xA9");
+
+    //the engines built on the same parser report the same errors
+    std::string err_com, err;
+    JSON11_TEST_ASSERT(Json::parse("[1, {\"a\": tru}]", err_com, Json::ParseEngine::LAZY).is_null());
+    Json::parse("[1, {\"a\": tru}]", err);
+    JSON11_TEST_ASSERT(err_com == err && err == "invalid literal, expected null, true or false at line 1, column 11");
+    JSON11_TEST_ASSERT(JsonPath("$.a").select("{\"a\": 1, \"b\": [}", err_com).empty());
+    JSON11_TEST_ASSERT(err_com == "invalid value at line 1, column 16");
+}
+
+void test28() {
+    using Error = ParseStatus::Error;
+    ParseStatus status;
+    //up to the limit, arrays and objects alike
+    std::string arrays = nested("[", "1", "]", 512), objects = nested("{\"k\":", "[]", "}", 511);
+    std::string mixed = nested("[{\"a\": ", "[{}]", "}]", 255);
+    for (auto *in : {&arrays, &objects, &mixed}){
+        Json value = Json::parse(*in, status);
+        JSON11_TEST_ASSERT(status.ok() && value.serialize() == Json::parse(value.serialize(), status).serialize());
+    }
+    Json value = Json::parse(arrays, status);
+    for (int i = 0; i < 511; ++i) value = value[0];
+    JSON11_TEST_ASSERT(value[0].int_value() == 1);
+
+    //one more is an error, at its opening bracket
+    for (const std::string &in : {nested("[", "1", "]", 513), nested("{\"k\":", "[]", "}", 512), nested("[{\"a\": ", "[[{}]]", "}]", 255)}){
+        std::string err_com;
+        JSON11_TEST_ASSERT(Json::parse(in, status).is_null() && status.error == Error::TOO_DEEP);
+        JSON11_TEST_ASSERT(in[status.offset] == '[' || in[status.offset] == '{');
+        JSON11_TEST_ASSERT(Json::parse(in, err_com).is_null() && err_com == status.message());
+        //the other engines built on the same parser have the same limit
+        std::string lazy_err, path_err, parallel_err, tape_err;
+        JSON11_TEST_ASSERT(Json::parse(in, lazy_err, Json::ParseEngine::LAZY).is_null() && lazy_err == err_com);
+        JSON11_TEST_ASSERT(Json::parse(in, tape_err, Json::ParseEngine::TWO_STAGE).is_null() && tape_err == err_com);
+        JSON11_TEST_ASSERT(JsonPath("$[0]").select(in, path_err).empty() && path_err == err_com);
+        JSON11_TEST_ASSERT(Json::parse_parallel(in, parallel_err, 2).is_null() && parallel_err == err_com);
+    }
+    std::string err_com;
+    JSON11_TEST_ASSERT(Json::parse(arrays, err_com, Json::ParseEngine::LAZY) == Json::parse(arrays, err_com));
+    JSON11_TEST_ASSERT(Json::parse(arrays, err_com, Json::ParseEngine::TWO_STAGE) == Json::parse(arrays, err_com));
+    JSON11_TEST_ASSERT(Json::parse_parallel(arrays, err_com, 2) == Json::parse(arrays, err_com) && err_com.empty());
+
+    ParseOptions options;
+    options.max_depth = 2;
+    JSON11_TEST_ASSERT(Json::parse("[[1], {\"a\": 2}, {}]", status, options).is_array() && status.ok());
+    JSON11_TEST_ASSERT(Json::parse("[[[]]]", status, options).is_null() && status.error == Error::TOO_DEEP && status.offset == 2);
+    JSON11_TEST_ASSERT(Json::parse("[1, {\"a\": [1]}]", status, options).is_null() && status.offset == 10);
+    options.max_depth = 0;
+    JSON11_TEST_ASSERT(Json::parse("  \"scalar\"", status, options).is_string() && status.ok());
+    JSON11_TEST_ASSERT(Json::parse("[]", status, options).is_null() && status.error == Error::TOO_DEEP);
+
+    //a hostile payload fails cleanly: nothing was built, and the parser has no recursion to overflow
+    std::string hostile(1000000, '[');
+    JSON11_TEST_ASSERT(Json::parse(hostile, status).is_null() && status.error == Error::TOO_DEEP && status.offset == 512);
+    JSON11_TEST_ASSERT(Json::parse(hostile, err_com, Json::ParseEngine::LAZY).is_null() && !err_com.empty());
+    std::string closed = hostile + std::string(hostile.size(), ']'), tape_err;
+    JSON11_TEST_ASSERT(Json::parse(closed, err_com).is_null() && Json::parse(closed, tape_err, Json::ParseEngine::TWO_STAGE).is_null());
+    JSON11_TEST_ASSERT(tape_err == err_com && err_com == "nesting too deep at line 1, column 513");
+    options.max_depth = SIZE_MAX;
+    JSON11_TEST_ASSERT(Json::parse(hostile, status, options).is_null() && status.error == Error::UNEXPECTED_END);
+    JSON11_TEST_ASSERT(status.offset == hostile.size());
+    std::string keys;
+    for (int i = 0; i < 200000; ++i) keys += "{\"k\": [0, ";
+    JSON11_TEST_ASSERT(Json::parse(keys, status, options).is_null() && status.error == Error::UNEXPECTED_END);
+}
+
+void test29() {
+    //one parser for a run of documents, failed ones included, with the results and errors of Json::parse
+    std::vector<std::string> docs = {
+        R"({"id": 1, "tags": ["a", "b\n"], "pos": {"x": 1.5, "y": [-2, [], {}]}})", "[1, 2", "\"a long string, with an \\u00e9 escape\"",
+        R"({"k": [true, null], "k": 1})", "[[[1]], {\"a\": }]", "[]", "  42  ", R"({"ab\u0063": [{"d": "e"}]})"};
+    Json::Parser parser, arena_parser(1024);
+    for (int round = 0; round < 2; ++round){
+        for (auto &in : docs){
+            ParseStatus expected_status, status, arena_status;
+            Json expected = Json::parse(in, expected_status);
+            JSON11_TEST_ASSERT(parser.parse(in, status) == expected && status.message() == expected_status.message());
+            JSON11_TEST_ASSERT(arena_parser.parse(in, arena_status) == expected && arena_status.message() == expected_status.message());
+            std::string err_com;
+            JSON11_TEST_ASSERT(parser.parse(in, err_com) == expected && err_com == (expected_status.ok() ? "" : expected_status.message()));
+        }
+    }
+    ParseOptions options;
+    options.max_depth = 1;
+    ParseStatus status;
+    JSON11_TEST_ASSERT(parser.parse("[[1]]", status, options).is_null() && status.error == ParseStatus::Error::TOO_DEEP);
+
+    //once warm, only the storage of the containers is left to allocate, the nodes are in the arena
+    std::string in = R"([1, "two", {"three": [true, null]}])";
+    arena_parser.parse(in, status);
+    size_t before = alloc_count;
+    Json doc = arena_parser.parse(in, status);
+    JSON11_TEST_ASSERT(status.ok() && alloc_count - before == 3);
+
+    //the arena of a document that is still alive is left alone, the next document gets another one
+    Json other = arena_parser.parse(R"(["x", {"y": "a string too long to stay inline"}])", status);
+    JSON11_TEST_ASSERT(doc == Json::parse(in, status) && other[1]["y"].string_value() == "a string too long to stay inline");
+    doc = Json();
+    other = Json();
+    arena_parser.parse(in, status);
+    before = alloc_count;
+    doc = arena_parser.parse(in, status);
+    JSON11_TEST_ASSERT(alloc_count - before == 3);
+    //and the documents outlive the parser
+    {
+        Json::Parser scoped(256);
+        other = scoped.parse(in, status);
+    }
+    JSON11_TEST_ASSERT(other == doc);
+#ifdef LXJSON_FLAT_OBJECT
+    //the documents of a parser share their keys
+    Json doc1 = parser.parse(R"({"name": 1})", status), doc2 = parser.parse(R"([{"name": 2}])", status);
+    JSON11_TEST_ASSERT(&doc1.object_value().begin()->first.str() == &doc2[0].object_value().begin()->first.str());
+#endif
+}
+
+
+void test30() {
+    using Error = ParseStatus::Error;
+    ParseOptions strict;
+    strict.validate_utf8 = true;
+    ParseStatus status;
+    //characters of 1 to 4 bytes, in keys and values, around escapes and at every position of a block
+    const std::string text = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80 \xEF\xBF\xBF \xF4\x8F\xBF\xBF";
+    for (size_t pad = 0; pad < 40; ++pad){
+        std::string s = std::string(pad, 'x') + text;
+        std::string in = "{\"" + s + "\": [\"" + s + "\", \"" + s + "\\n" + s + "\"]}";
+        Json value = Json::parse(in, status, strict);
+        JSON11_TEST_ASSERT(status.ok() && value == Json::parse(in, status));
+        JSON11_TEST_ASSERT(value[s][1].string_value() == s + "\n" + s);
+    }
+
+    //the error is on the first byte that is not part of a character
+    struct Bad{
+        const char *bytes;
+        size_t offset;
+    };
+    const Bad bad[] = {
+        {"\xE2\x82", 0}, {"\xF0\x9F\x98", 0}, {"\xC0\x80", 0}, {"\xE0\x9F\xBF", 0}, {"\xF0\x8F\xBF\xBF", 0},
+        {"\xED\xA0\x80", 0}, {"\xF4\x90\x80\x80", 0}, {"\xF5\x80\x80\x80", 0}, {"\xFF", 0}, {"a\x80", 1}, {"\xC3\xA9\xA9", 2}};
+    for (auto &b : bad){
+        for (size_t pad = 0; pad < 70; ++pad){
+            std::string in = "[\"" + std::string(pad, 'x') + b.bytes + std::string(pad % 7, 'y') + "\"]";
+            JSON11_TEST_ASSERT(Json::parse(in, status, strict).is_null() && status.error == Error::INVALID_UTF8);
+            JSON11_TEST_ASSERT(status.offset == 2 + pad + b.offset);
+            //without the option the bytes are taken as they are
+            JSON11_TEST_ASSERT(Json::parse(in, status).is_array());
+        }
+    }
+    JSON11_TEST_ASSERT(Json::parse("{\"k\\n\xC0\x80\": 1}", status, strict).is_null() && status.offset == 5);
+    JSON11_TEST_ASSERT(status.message() == "invalid UTF-8 in string at line 1, column 6");
+    Json::Parser parser;
+    JSON11_TEST_ASSERT(parser.parse("[\"\xE2\x82\xAC\", \"\xE2\x82\"]", status, strict).is_null() && status.offset == 9);
+    JSON11_TEST_ASSERT(parser.parse("[\"\xE2\x82\xAC\"]", status, strict)[0].string_value() == "\xE2\x82\xAC");
+
+    //a surrogate pair of escapes is one character, a surrogate alone is an error with or without the option
+    JSON11_TEST_ASSERT(Json::parse("\"\\ud83d\\ude00\"", status, strict).string_value() == "\xF0\x9F\x98\x80");
+    const Bad escapes[] = {{"\"\\udc00\"", 1}, {"\"\\ud800\\u0041\"", 7}, {"\"\\ud800\\ud800\"", 7}, {"\"a\\ude00\\ud83d\"", 2}};
+    for (auto &e : escapes){
+        for (auto *options : {&strict, static_cast<ParseOptions *>(nullptr)}){
+            Json value = options ? Json::parse(e.bytes, status, *options) : Json::parse(e.bytes, status);
+            JSON11_TEST_ASSERT(value.is_null() && status.error == Error::INVALID_UNICODE_ESCAPE && status.offset == e.offset);
+        }
+    }
+
+    //on random text, valid or not, the parser agrees with the validation of the serializer
+    SerializeOptions validate;
+    validate.unicode = SerializeOptions::Unicode::VALIDATE;
+    const char *pieces[] = {"a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\x80", "\xC0", "\xED\xA0", "\xF4\x90", "\xE0\xA0", "\xFF"};
+    uint32_t seed = 7;
+    auto next = [&seed](uint32_t n){
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % n;
+    };
+    for (int i = 0; i < 3000; ++i){
+        std::string s;
+        for (uint32_t k = next(50); k; --k) s += next(10) ? pieces[next(4)] : pieces[4 + next(6)];
+        bool valid = true;
+        try { Json(s).serialize(validate); } catch (std::runtime_error &) { valid = false; }
+        Json value = Json::parse("\"" + s + "\"", status, strict);
+        JSON11_TEST_ASSERT(status.ok() == valid && (!valid || value.string_value() == s));
+    }
+}
+
+
+void test31() {
+    std::string err_com;
+    //a value owned alone is edited in place
+    Json doc = Json::parse(R"({"name": "a", "tags": ["x"], "pos": {"x": 1, "y": 2}, "other": {"z": [3]}})", err_com);
+    const Json::object *root = &doc.object_value();
+    doc.edit("name") = Json("b");
+    doc.edit("pos").set("x", Json(10));
+    doc.edit("tags").push_back(Json("y"));
+    JSON11_TEST_ASSERT(&doc.object_value() == root);
+    JSON11_TEST_ASSERT(doc == Json::parse(R"({"name": "b", "tags": ["x", "y"], "pos": {"x": 10, "y": 2}, "other": {"z": [3]}})", err_com));
+
+    //a shared one is copied along the path of the edit only, the other owner keeps the old tree
+    Json snapshot = doc;
+    doc.edit("pos").edit("y") = Json(20);
+    JSON11_TEST_ASSERT(snapshot["pos"]["y"].int_value() == 2 && doc["pos"]["y"].int_value() == 20);
+    JSON11_TEST_ASSERT(&doc.object_value() != &snapshot.object_value() && &doc["pos"].object_value() != &snapshot["pos"].object_value());
+    JSON11_TEST_ASSERT(&doc["other"].object_value() == &snapshot["other"].object_value());
+    JSON11_TEST_ASSERT(&doc["tags"].array_value() == &snapshot["tags"].array_value());
+    //then it is owned alone again
+    root = &doc.object_value();
+    doc.edit("pos").edit("y") = Json(21);
+    JSON11_TEST_ASSERT(&doc.object_value() == root && snapshot["pos"]["y"].int_value() == 2);
+
+    //erase, a member that is not there leaves a shared object shared
+    snapshot = doc;
+    JSON11_TEST_ASSERT(!doc.erase("missing") && &doc.object_value() == &snapshot.object_value());
+    JSON11_TEST_ASSERT(doc.erase("name") && !doc.object_value().count("name") && snapshot["name"] == Json("b"));
+    doc.edit("tags").erase(0);
+    JSON11_TEST_ASSERT(doc["tags"] == Json(Json::array{Json("y")}) && snapshot["tags"].array_value().size() == 2);
+
+    //a null value grows into what the edit needs, edit() inserts the missing members
+    Json built;
+    built.edit("a").edit("b") = Json(1);
+    built.edit("a").edit("list").push_back(Json(true));
+    built.edit("a").edit("list").edit(0) = Json(false);
+    JSON11_TEST_ASSERT(built.serialize() == R"({"a": {"b": 1, "list": [false]}})");
+    bool thrown = false;
+    try { built.edit("a").edit("b").push_back(Json(2)); } catch (std::runtime_error &) { thrown = true; }
+    JSON11_TEST_ASSERT(thrown);
+    thrown = false;
+    try { built.edit("a").edit("list").edit(1); } catch (std::out_of_range &) { thrown = true; }
+    JSON11_TEST_ASSERT(thrown);
+
+    //documents in an arena, lazy ones, and the copies shared with other threads
+    Json::Parser parser(1024);
+    const std::string text = R"({"k": [1, {"v": "long enough to need a node of its own"}], "n": null})";
+    Json parsed = parser.parse(text, err_com);
+    parsed.edit("k").edit(1).set("v", Json("edited"));
+    JSON11_TEST_ASSERT(parser.parse(text, err_com)["k"][1]["v"].string_value() == "long enough to need a node of its own");
+    JSON11_TEST_ASSERT(parsed["k"][1]["v"].string_value() == "edited");
+    Json lazy = Json::parse(text, err_com, Json::ParseEngine::LAZY), lazy_copy = lazy;
+    lazy.edit("k").edit(1).set("v", Json("edited"));
+    JSON11_TEST_ASSERT(lazy == parsed && lazy_copy == Json::parse(text, err_com));
+    std::vector<std::thread> threads;
+    std::atomic<int> done(0);
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]{
+            Json mine = parsed;
+            for (int i = 0; i < 1000; ++i) mine.edit("k").edit(1).set("v", Json(t * 1000 + i));
+            done += mine["k"][1]["v"].int_value() == t * 1000 + 999 && mine["k"][0].int_value() == 1;
+        });
+    for (auto &thread : threads) thread.join();
+    JSON11_TEST_ASSERT(done == 4 && parsed["k"][1]["v"].string_value() == "edited");
+#ifdef LXJSON_FLAT_OBJECT
+    KeyTable keys;
+    Json interned = Json::parse(R"({"key": 1})", err_com, keys);
+    interned.edit(keys.intern("key")) = Json(2);
+    interned.edit(keys.intern("new")) = Json(3);
+    JSON11_TEST_ASSERT(interned.serialize() == R"({"key": 2, "new": 3})");
+#endif
+}
+
 
 int main()
 {
@@ -152,7 +1523,31 @@ int main()
     }
     JSON11_TEST_ASSERT(ret.is_object());
 
+    TEST_COPY_SHARES;
+    TEST_PARSE_NO_COPIES;
+    TEST_PARSE_ARENA;
+    TEST_INLINE_SCALARS;
+    TEST_PARSE_LONG_STRINGS;
+    TEST_PARSE_TWO_STAGE;
+    TEST_PARSE_EXACT_NUMBERS;
+    TEST_SERIALIZE_NUMBERS;
+    TEST_PARSE_STREAM;
+    TEST_PARSE_FILE;
+    TEST_FLAT_OBJECT;
+    TEST_INTERNED_KEYS;
+    TEST_PARSE_LAZY;
+    TEST_JSON_PATH;
+    TEST_SERIALIZE_SINKS;
+    TEST_SERIALIZE_ESCAPES;
+    TEST_SERIALIZE_OPTIONS;
+    TEST_CBOR;
+    TEST_NDJSON;
+    TEST_PARSE_PARALLEL;
+    TEST_PARSE_STATUS;
+    TEST_PARSE_DEPTH;
+    TEST_PARSER;
+    TEST_STRICT_UTF8;
+    TEST_EDIT;
 
-    
     return 0;
 }
\ No newline at end of file